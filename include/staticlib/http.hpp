@@ -26,15 +26,23 @@
 
 #include "staticlib/config.hpp"
 
+#include "staticlib/http/file_body.hpp"
 #include "staticlib/http/http_exception.hpp"
 #include "staticlib/http/multi_threaded_session.hpp"
+#include "staticlib/http/parallel_download.hpp"
+#include "staticlib/http/parallel_upload.hpp"
+#include "staticlib/http/polling_event.hpp"
 #include "staticlib/http/polling_session.hpp"
+#include "staticlib/http/request_body.hpp"
 #include "staticlib/http/request_options.hpp"
 #include "staticlib/http/resource.hpp"
 #include "staticlib/http/resource_info.hpp"
+#include "staticlib/http/resource_timeline.hpp"
 #include "staticlib/http/session.hpp"
+#include "staticlib/http/session_metrics.hpp"
 #include "staticlib/http/session_options.hpp"
 #include "staticlib/http/single_threaded_session.hpp"
+#include "staticlib/http/upload_stream.hpp"
 
 #endif /* STATICLIB_HTTP_HPP */
 
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   file_body.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 10:05 PM
+ */
+
+#ifndef STATICLIB_HTTP_FILE_BODY_HPP
+#define STATICLIB_HTTP_FILE_BODY_HPP
+
+#include <string>
+
+#include "staticlib/http/http_exception.hpp"
+#include "staticlib/http/request_body.hpp"
+
+namespace staticlib {
+namespace http {
+
+/**
+ * Creates a request body from the contents of the specified file.
+ * File is mapped into memory (with sequential access hint) and is passed
+ * to the transfer without copying, "Content-Length" is set to the file size.
+ * Mapping is kept until all requests that use the returned body are finished,
+ * file must not be truncated while it is mapped.
+ *
+ * @param path path to a regular file
+ * @return request body
+ * @throws http_exception if file cannot be mapped
+ */
+request_body map_file_body(const std::string& path);
+
+} // namespace
+}
+
+#endif /* STATICLIB_HTTP_FILE_BODY_HPP */
+
@@ -25,6 +25,7 @@
 #define STATICLIB_HTTP_MULTI_THREADED_SESSION_HPP
 
 #include "staticlib/http/session.hpp"
+#include "staticlib/http/upload_stream.hpp"
 
 namespace staticlib {
 namespace http {
@@ -71,6 +72,35 @@ public:
             const std::string& url,
             std::unique_ptr<std::istream> post_data,
             request_options options = request_options{}) override;
+
+    /**
+     * Opens specified HTTP url as a Source using POST method,
+     * body data is passed to the transfer without copying
+     * 
+     * @param url HTTP URL
+     * @param body request body
+     * @param options request options
+     * @return HTTP resource
+     */
+    virtual resource open_url(
+            const std::string& url,
+            request_body body,
+            request_options options = request_options{}) override;
+
+    /**
+     * Opens specified HTTP url as a Source using POST method,
+     * request body is pushed by the client into the specified stream
+     * from its own thread, stream must be closed at the end of the body
+     * 
+     * @param url HTTP URL
+     * @param post_data stream to push the request body into
+     * @param options request options
+     * @return HTTP resource
+     */
+    resource open_url(
+            const std::string& url,
+            upload_stream& post_data,
+            request_options options = request_options{});
 };
 
 } // namespace
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   parallel_download.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 11:40 PM
+ */
+
+#ifndef STATICLIB_HTTP_PARALLEL_DOWNLOAD_HPP
+#define STATICLIB_HTTP_PARALLEL_DOWNLOAD_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "staticlib/pimpl.hpp"
+
+#include "staticlib/http/http_exception.hpp"
+#include "staticlib/http/polling_session.hpp"
+#include "staticlib/http/request_options.hpp"
+#include "staticlib/http/resource_info.hpp"
+
+namespace staticlib {
+namespace http {
+
+/**
+ * Range of the downloaded file fetched with a single request
+ */
+struct download_segment {
+    /**
+     * Zero-based segment number
+     */
+    uint32_t index = 0;
+    /**
+     * Offset of the segment in the file
+     */
+    uint64_t offset = 0;
+    /**
+     * Segment size in bytes
+     */
+    uint64_t length = 0;
+};
+
+/**
+ * Outcome of the segment download, reported after each attempt
+ */
+struct download_segment_result {
+    /**
+     * Downloaded segment
+     */
+    download_segment segment;
+    /**
+     * Number of requests made for this segment
+     */
+    uint32_t attempts = 0;
+    /**
+     * Whether segment was received completely
+     */
+    bool success = false;
+    /**
+     * Response status code of the last attempt
+     */
+    uint16_t status_code = 0;
+    /**
+     * Timings and transfer stats of the last attempt
+     */
+    resource_info info;
+    /**
+     * Error message of the last attempt
+     */
+    std::string error;
+};
+
+/**
+ * Downloads a file as a set of ranges (segments) concurrently over multiple
+ * connections of the specified polling session. Size and range support are
+ * checked with a "HEAD" request first, if server does not report "Content-Length"
+ * or does not accept byte ranges, file is downloaded with a single "GET" request.
+ * Otherwise the destination file is preallocated and each segment is written
+ * directly at its offset. Segments that failed to connect, timed out or received
+ * 408, 429 or 5xx status code are retried after a delay, that starts at 100 ms
+ * and is doubled on every attempt up to 10 seconds ("Retry-After" delay-seconds
+ * value is honoured up to the same limit). Session must not be used for other
+ * requests while the job is running.
+ */
+class parallel_download : public sl::pimpl::object {
+protected:
+    /**
+     * Implementation class
+     */
+    class impl;
+
+public:
+    /**
+     * PIMPL-specific constructor
+     *
+     * @param pimpl impl object
+     */
+    PIMPL_CONSTRUCTOR(parallel_download)
+
+    /**
+     * Constructor
+     *
+     * @param session session to run the segments on
+     * @param url HTTP URL of the file
+     * @param file_path destination path, file is created or truncated
+     * @param segment_size max size of a single segment
+     * @param max_concurrency max number of segments downloaded at the same time
+     * @param options request options used for all requests
+     * @param max_attempts max number of requests for a single segment
+     * @param progress optional callback, called after each finished attempt
+     */
+    parallel_download(polling_session& session, const std::string& url, const std::string& file_path,
+            uint64_t segment_size, uint32_t max_concurrency, request_options options = request_options(),
+            uint32_t max_attempts = 3,
+            std::function<void(const download_segment_result&)> progress = nullptr);
+
+    /**
+     * Downloads all segments, blocks until all segments are finished
+     *
+     * @return results for all segments ordered by segment index
+     */
+    std::vector<download_segment_result> run();
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_HTTP_PARALLEL_DOWNLOAD_HPP */
+
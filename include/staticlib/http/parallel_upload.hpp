@@ -0,0 +1,170 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   parallel_upload.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 10:50 PM
+ */
+
+#ifndef STATICLIB_HTTP_PARALLEL_UPLOAD_HPP
+#define STATICLIB_HTTP_PARALLEL_UPLOAD_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "staticlib/pimpl.hpp"
+
+#include "staticlib/http/http_exception.hpp"
+#include "staticlib/http/polling_session.hpp"
+#include "staticlib/http/request_body.hpp"
+#include "staticlib/http/request_options.hpp"
+
+namespace staticlib {
+namespace http {
+
+/**
+ * Range of the uploaded body sent as a single request
+ */
+struct upload_part {
+    /**
+     * Zero-based part number
+     */
+    uint32_t index = 0;
+    /**
+     * Offset of the part in the body
+     */
+    uint64_t offset = 0;
+    /**
+     * Part size in bytes
+     */
+    uint64_t length = 0;
+};
+
+/**
+ * Request parameters for a single part, "PUT" method
+ * is used if method is not specified in options
+ */
+struct upload_part_target {
+    /**
+     * HTTP URL
+     */
+    std::string url;
+    /**
+     * Request options
+     */
+    request_options options;
+};
+
+/**
+ * Outcome of the part upload, reported after the last attempt
+ */
+struct upload_part_result {
+    /**
+     * Uploaded part
+     */
+    upload_part part;
+    /**
+     * Number of requests made for this part
+     */
+    uint32_t attempts = 0;
+    /**
+     * Whether part was accepted by server (with 2xx status code)
+     */
+    bool success = false;
+    /**
+     * Response status code of the last attempt
+     */
+    uint16_t status_code = 0;
+    /**
+     * Response headers of the last attempt (e.g. to collect ETags)
+     */
+    std::vector<std::pair<std::string, std::string>> headers;
+    /**
+     * Error message of the last attempt
+     */
+    std::string error;
+};
+
+/**
+ * Uploads a body as a set of ranges (parts) concurrently over multiple
+ * connections of the specified polling session, part bodies share
+ * the memory of the source body. Parts that failed to connect,
+ * timed out or received 408, 429 or 5xx status code are retried after
+ * a delay, that starts at 100 ms and is doubled on every attempt up to
+ * 10 seconds ("Retry-After" delay-seconds value is honoured up to the same limit).
+ * Session must not be used for other requests while the job is running.
+ */
+class parallel_upload : public sl::pimpl::object {
+protected:
+    /**
+     * Implementation class
+     */
+    class impl;
+
+public:
+    /**
+     * PIMPL-specific constructor
+     *
+     * @param pimpl impl object
+     */
+    PIMPL_CONSTRUCTOR(parallel_upload)
+
+    /**
+     * Constructor
+     *
+     * @param session session to run the parts on
+     * @param body body to upload, see 'map_file_body' for files
+     * @param part_size max size of a single part
+     * @param max_concurrency max number of parts uploaded at the same time
+     * @param target_generator URL and options generator for parts
+     * @param max_attempts max number of requests for a single part
+     */
+    parallel_upload(polling_session& session, request_body body, uint64_t part_size,
+            uint32_t max_concurrency, std::function<upload_part_target(const upload_part&)> target_generator,
+            uint32_t max_attempts = 3);
+
+    /**
+     * Constructor
+     *
+     * @param session session to run the parts on
+     * @param file_path path to the file to upload, file is mapped into memory
+     * @param part_size max size of a single part
+     * @param max_concurrency max number of parts uploaded at the same time
+     * @param target_generator URL and options generator for parts
+     * @param max_attempts max number of requests for a single part
+     */
+    parallel_upload(polling_session& session, const std::string& file_path, uint64_t part_size,
+            uint32_t max_concurrency, std::function<upload_part_target(const upload_part&)> target_generator,
+            uint32_t max_attempts = 3);
+
+    /**
+     * Uploads all parts, blocks until all parts are finished
+     *
+     * @return results for all parts ordered by part index
+     */
+    std::vector<upload_part_result> run();
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_HTTP_PARALLEL_UPLOAD_HPP */
+
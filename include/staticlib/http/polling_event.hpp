@@ -0,0 +1,82 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * File:   polling_event.hpp
+ * Author: alex
+ *
+ * Created on October 19, 2026, 9:10 AM
+ */
+
+#ifndef STATICLIB_HTTP_POLLING_EVENT_HPP
+#define STATICLIB_HTTP_POLLING_EVENT_HPP
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace staticlib {
+namespace http {
+
+/**
+ * Type of the event reported by polling session for a running streaming request
+ */
+enum class polling_event_type {
+    /**
+     * Status line and headers of the final response were received
+     */
+    headers_ready,
+    /**
+     * Chunk of the response body was received
+     */
+    data_available
+};
+
+/**
+ * Progress of the running request with 'request_options::polling_streaming'
+ * enabled, events of the same request are reported in order, all of them are
+ * reported before the finished request is returned from 'polling_session::poll'
+ */
+struct polling_event {
+    /**
+     * Event type
+     */
+    polling_event_type type = polling_event_type::data_available;
+    /**
+     * ID of the resource returned from 'open_url'
+     */
+    uint64_t resource_id = 0;
+    /**
+     * Response status code, set for 'headers_ready'
+     */
+    uint16_t status_code = 0;
+    /**
+     * Response headers, set for 'headers_ready'
+     */
+    std::vector<std::pair<std::string, std::string>> headers;
+    /**
+     * Body data received since the previous poll, set for 'data_available'
+     */
+    std::vector<char> data;
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_HTTP_POLLING_EVENT_HPP */
+
@@ -25,6 +25,7 @@
 #define STATICLIB_HTTP_POLLING_SESSION_HPP
 
 #include "staticlib/http/session.hpp"
+#include "staticlib/http/polling_event.hpp"
 
 #include <vector>
 
@@ -33,7 +34,7 @@ namespace http {
 
 /**
  * Single-threaded "session" implementation, that can perform multiple requests
- * simultaneously. NOT thread-safe.
+ * simultaneously. NOT thread-safe, except "submit_url" and "wakeup" methods.
  * TCP connections are cached where possible and are bound to the session object.
  */
 class polling_session : public session {
@@ -74,12 +75,100 @@ public:
             request_options options = request_options{}) override;
 
     /**
-     * Poll the queue making cURL to actually process the requests
+     * Opens specified HTTP url as a Source using POST method,
+     * body data is passed to the transfer without copying
+     * 
+     * @param url HTTP URL
+     * @param body request body
+     * @param options request options
+     * @return HTTP resource
+     */
+    virtual resource open_url(
+            const std::string& url,
+            request_body body,
+            request_options options = request_options{}) override;
+
+    /**
+     * Submits the request from any thread, it is added to the queue
+     * at the start of the next poll round, blocked "poll" is woken up;
+     * errors of adding the request are reported as a finished request
+     * with an error message (zero status code)
+     *
+     * @param url HTTP URL
+     * @param options request options, "GET" method is used by default
+     * @return empty HTTP resource with the ID of the request
+     */
+    resource submit_url(
+            const std::string& url,
+            request_options options = request_options{});
+
+    /**
+     * Submits the request with a body from any thread, see "submit_url" above
+     *
+     * @param url HTTP URL
+     * @param body request body
+     * @param options request options, "POST" method is used by default
+     * @return empty HTTP resource with the ID of the request
+     */
+    resource submit_url(
+            const std::string& url,
+            request_body body,
+            request_options options = request_options{});
+
+    /**
+     * Wakes up the "poll" call, that is waiting on sockets, can be called
+     * from any thread, has no effect with cURL older than 7.68.0
+     * (poll waits are limited to "fdset_timeout_millis" in that case)
+     */
+    void wakeup();
+
+    /**
+     * Poll the queue making cURL to actually process the requests,
+     * throws "http_exception" if requests with "polling_streaming"
+     * enabled are enqueued (their data would be lost)
      * 
      * @return list of requests, that finished execution
      */
     std::vector<resource> poll();
 
+    /**
+     * Poll the queue making cURL to actually process the requests,
+     * reports the progress of the requests with "polling_streaming" enabled
+     *
+     * @param events list to append the streaming events to
+     * @return list of requests, that finished execution
+     */
+    std::vector<resource> poll(std::vector<polling_event>& events);
+
+    /**
+     * Poll the queue repeatedly (waiting on sockets between the rounds) until
+     * the specified number of requests is finished, timeout is elapsed or
+     * the queue becomes empty, at least one round is performed;
+     * idle session waits for the requests submitted from other threads
+     *
+     * @param timeout_millis max time to spend in this call
+     * @param min_completions number of finished requests to wait for
+     * @param out list to append the finished requests to, it is not cleared
+     * @return number of appended requests
+     */
+    size_t poll(uint32_t timeout_millis, size_t min_completions, std::vector<resource>& out);
+
+    /**
+     * Poll the queue repeatedly (waiting on sockets between the rounds) until
+     * the specified number of requests is finished, timeout is elapsed,
+     * the queue becomes empty or the streaming events are reported,
+     * at least one round is performed; idle session waits for the requests
+     * submitted from other threads
+     *
+     * @param timeout_millis max time to spend in this call
+     * @param min_completions number of finished requests to wait for
+     * @param out list to append the finished requests to, it is not cleared
+     * @param events list to append the streaming events to
+     * @return number of appended requests
+     */
+    size_t poll(uint32_t timeout_millis, size_t min_completions, std::vector<resource>& out,
+            std::vector<polling_event>& events);
+
     /**
      * Number of request, that were submitted for execution and
      * not yet finished
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   request_body.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 9:05 PM
+ */
+
+#ifndef STATICLIB_HTTP_REQUEST_BODY_HPP
+#define STATICLIB_HTTP_REQUEST_BODY_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "staticlib/io.hpp"
+
+namespace staticlib {
+namespace http {
+
+/**
+ * Request body that is sent directly from the client memory without copying
+ * it into intermediate buffers, body size is known in advance and is sent
+ * as "Content-Length". Instances are cheap to copy, the same body can be
+ * used with any number of requests (from different threads) simultaneously.
+ */
+class request_body {
+    std::vector<sl::io::span<const char>> segments;
+    std::shared_ptr<const void> owner;
+    uint64_t total_size = 0;
+    bool present = false;
+
+public:
+    /**
+     * Default constructor, creates an instance without body
+     */
+    request_body() { }
+
+    /**
+     * Constructor, data must stay valid until the request is finished
+     *
+     * @param data contiguous body data
+     */
+    request_body(sl::io::span<const char> data) :
+    present(true) {
+        add_segment(data);
+    }
+
+    /**
+     * Constructor, data is kept alive by the requests that use it
+     *
+     * @param data body data shared between requests
+     */
+    request_body(std::shared_ptr<const std::string> data) :
+    owner(data),
+    present(true) {
+        if (nullptr != data.get()) {
+            add_segment({data->data(), data->size()});
+        }
+    }
+
+    /**
+     * Constructor, segments are sent one after another,
+     * memory of all segments must stay valid while 'owner' is alive
+     *
+     * @param segments list of body segments
+     * @param owner optional object that keeps segments memory alive
+     */
+    request_body(std::vector<sl::io::span<const char>> segments,
+            std::shared_ptr<const void> owner = std::shared_ptr<const void>()) :
+    owner(std::move(owner)),
+    present(true) {
+        this->segments.reserve(segments.size());
+        for (auto& sp : segments) {
+            add_segment(sp);
+        }
+    }
+
+    /**
+     * Whether this instance contains a body (that may have zero size)
+     *
+     * @return true if body is present
+     */
+    bool is_present() const {
+        return present;
+    }
+
+    /**
+     * Body segments, empty segments are skipped
+     *
+     * @return list of segments
+     */
+    const std::vector<sl::io::span<const char>>& get_segments() const {
+        return segments;
+    }
+
+    /**
+     * Total size of the body in bytes
+     *
+     * @return body size
+     */
+    uint64_t size() const {
+        return total_size;
+    }
+
+    /**
+     * Creates a body over the specified range of this body,
+     * memory is shared, no data is copied
+     *
+     * @param offset range start
+     * @param length range length, truncated to the end of this body
+     * @return body over the specified range
+     */
+    request_body slice(uint64_t offset, uint64_t length) const {
+        auto res = request_body();
+        res.owner = owner;
+        res.present = present;
+        uint64_t seg_start = 0;
+        for (auto& sp : segments) {
+            uint64_t seg_end = seg_start + sp.size();
+            if (seg_end > offset && seg_start < offset + length) {
+                uint64_t from = offset > seg_start ? offset - seg_start : 0;
+                uint64_t to = offset + length < seg_end ? offset + length - seg_start : sp.size();
+                res.add_segment({sp.data() + from, static_cast<size_t> (to - from)});
+            }
+            seg_start = seg_end;
+        }
+        return res;
+    }
+
+private:
+    void add_segment(sl::io::span<const char> sp) {
+        if (sp.size() > 0) {
+            segments.push_back(sp);
+            total_size += sp.size();
+        }
+    }
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_HTTP_REQUEST_BODY_HPP */
+
@@ -24,7 +24,10 @@
 #ifndef STATICLIB_HTTP_REQUEST_OPTIONS_HPP
 #define STATICLIB_HTTP_REQUEST_OPTIONS_HPP
 
+#include <memory>
 #include <string>
+#include <typeindex>
+#include <typeinfo>
 #include <vector>
 #include <utility>
 #include <cstdint>
@@ -40,10 +43,21 @@ struct request_options {
     // options implemented manually
 
     /**
-     * Headers to send with a request
+     * Headers to send with a request, prepared header list is cached
+     * by the session and is shared between requests with the same headers;
+     * cache is enabled by default (see "session_options::request_headers_cache_max_size")
+     * and cached lists (including values like "Authorization") are kept in memory
+     * until evicted or until the session is destroyed, values that change
+     * between requests should be passed in "dynamic_headers"
      */
     std::vector<std::pair<std::string, std::string>> headers;
 
+    /**
+     * Headers to send with a request, that are specific to this request;
+     * unlike "headers" they are not cached by the session
+     */
+    std::vector<std::pair<std::string, std::string>> dynamic_headers;
+
     /**
      * HTTP method to use
      */
@@ -60,6 +74,18 @@ struct request_options {
      */
     bool abort_on_response_error = true;
 
+    /**
+     * Multi-threaded session only: max number of times the "GET" request is re-issued,
+     * when the transfer of a "200" response body fails (e.g. on timeout or connection reset),
+     * request is re-issued with "Range" header starting from the first byte not yet received
+     * and with "If-Range" header set to the strong "ETag" (or "Last-Modified") of the original
+     * response, consumer continues reading the same resource, HttpException is thrown
+     * from read method if the representation was changed, zero value disables resuming;
+     * "accept_encoding" is ignored for such requests, so the offsets are not affected
+     * by content decoding
+     */
+    uint16_t resume_max_attempts = 0;
+
     /**
      * Max allowed number of response headers
      */
@@ -72,7 +98,9 @@ struct request_options {
 
     /**
      * Whether to specify a "Content-Length" header for the request body,
-     * not specified by default, "Transfer-Encoding: chunked" is used instead.
+     * not required for sized bodies and seekable streams (string and file streams),
+     * their size is detected automatically, "Transfer-Encoding: chunked"
+     * is used for other streams by default.
      * If set to "true", then client must also specify a "request_body_content_length" parameter
      */
     bool send_request_body_content_length = false;
@@ -81,7 +109,21 @@ struct request_options {
      * "Content-Length" header value for request body,
      * used only if "send_request_body_content_length" is enabled
      */
-    uint32_t request_body_content_length = 0;
+    uint64_t request_body_content_length = 0;
+
+    /**
+     * Whether to allow "Expect: 100-continue" header for requests with body,
+     * disabled by default, so the body is sent without waiting for
+     * the "100 Continue" response from server (that may never come)
+     */
+    bool send_expect_100_continue = false;
+
+    /**
+     * Time to wait for the "100 Continue" response before sending the body,
+     * used only if "send_expect_100_continue" is enabled, cURL default is used if zero,
+     * https://curl.haxx.se/libcurl/c/CURLOPT_EXPECT_100_TIMEOUT_MS.html
+     */
+    uint32_t expect_100_timeout_millis = 0;
 
     /**
      * Polling session will write response body into the specified file
@@ -89,18 +131,101 @@ struct request_options {
      */
     std::string polling_response_body_file_path = "";
 
+    /**
+     * If non-negative, polling session will write response body into the existing
+     * file specified in "polling_response_body_file_path" starting at this offset,
+     * file is not truncated (so multiple requests can fill different ranges of it);
+     * if "Range: bytes=first-last" header is specified, body is written only
+     * for "206" response with "Content-Range" starting at "first" and only up to
+     * the requested length, request fails otherwise
+     */
+    int64_t polling_response_body_file_offset = -1;
+
+    /**
+     * Polling session will flush the file specified in "polling_response_body_file_path"
+     * to disk (fdatasync/FlushFileBuffers) before reporting the request as finished
+     */
+    bool polling_response_body_file_sync = false;
+
     /**
      * Request in polling session with in-memory response body
      * will fail if this limit is exceeded
      */
     uint32_t polling_response_body_max_size_bytes = 0;
 
+    /**
+     * Polling session will keep in-memory response body in memory only up to this size,
+     * larger bodies are moved into an anonymous temporary file that is mapped into
+     * memory when the request is finished, 0 disables spilling to disk
+     */
+    uint64_t polling_response_body_spill_threshold_bytes = 0;
+
+    /**
+     * Directory for the temporary files of "polling_response_body_spill_threshold_bytes",
+     * system temporary directory is used if empty
+     */
+    std::string polling_response_body_spill_dir = "";
+
+    /**
+     * Polling session will deliver response body while the transfer is running
+     * as "polling_event" instances (see "polling_session::poll"), finished
+     * resource has an empty body then; "poll" overloads without "events"
+     * argument throw while such requests are enqueued
+     */
+    bool polling_streaming = false;
+
+    /**
+     * Max size of the received streaming data that is not yet reported by "poll",
+     * transfer is paused when this limit is reached and resumed on the next "poll"
+     */
+    uint32_t polling_streaming_window_bytes = 1 << 20;
+
+    /**
+     * Multi-threaded session will write response body into the specified file
+     * directly from the worker thread, resource "read" returns EOF
+     * when the transfer is finished
+     */
+    std::string multi_threaded_response_body_file_path = "";
+
+    /**
+     * Size of the writes to "multi_threaded_response_body_file_path",
+     * rounded up to the multiple of 4096 bytes
+     */
+    uint32_t multi_threaded_response_body_file_batch_size_bytes = 1 << 20;
+
+    /**
+     * Bypass the OS page cache when writing "multi_threaded_response_body_file_path"
+     * (O_DIRECT on Linux, F_NOCACHE on macOS, FILE_FLAG_NO_BUFFERING on Windows),
+     * ignored if not supported by the file system
+     */
+    bool multi_threaded_response_body_file_direct_io = false;
+
     /**
      * Arbitrary user provided string, that is not used during
      * request processing and is available from resource
      */
     std::string user_options = "";
 
+    /**
+     * Arbitrary user provided object, that is not used during
+     * request processing and is available from resource,
+     * should be set with "set_user_context"
+     * (see "resource::get_user_context")
+     */
+    std::shared_ptr<void> user_context;
+
+    /**
+     * Type of the "user_context" object, set by "set_user_context"
+     * and checked by "resource::get_user_context"
+     */
+    std::type_index user_context_type = std::type_index(typeid(void));
+
+    /**
+     * Record monotonic timestamps of the request lifecycle events,
+     * available from resource after the request is finished
+     */
+    bool record_timeline = false;
+
     // general behavior options
 
     /**
@@ -236,6 +361,17 @@ struct request_options {
      * https://curl.haxx.se/libcurl/c/CURLOPT_SSL_CIPHER_LIST.html
      */
     std::string ssl_cipher_list = "";
+
+    /**
+     * Sets "user_context" along with its type
+     *
+     * @param ctx user provided object
+     */
+    template<typename T>
+    void set_user_context(std::shared_ptr<T> ctx) {
+        this->user_context = std::move(ctx);
+        this->user_context_type = std::type_index(typeid(T));
+    }
 };
 
 } // namespace
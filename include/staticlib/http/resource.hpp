@@ -29,6 +29,8 @@
 #include <istream>
 #include <memory>
 #include <string>
+#include <typeindex>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 
@@ -39,6 +41,7 @@
 #include "staticlib/http/http_exception.hpp"
 #include "staticlib/http/request_options.hpp"
 #include "staticlib/http/resource_info.hpp"
+#include "staticlib/http/resource_timeline.hpp"
 
 namespace staticlib {
 namespace http {
@@ -90,6 +93,14 @@ public:
      */
     virtual resource_info get_info() const;
 
+    /**
+     * Accessor for the request lifecycle timestamps,
+     * empty if 'record_timeline' option was not enabled
+     * 
+     * @return request lifecycle timestamps
+     */
+    virtual resource_timeline get_timeline() const;
+
     /**
      * Accessor for received headers
      * 
@@ -129,12 +140,51 @@ public:
      */
     virtual const request_options& get_request_options() const;
 
+    /**
+     * User context that was specified for this request
+     * with "request_options::set_user_context"
+     *
+     * @return context object, empty pointer if not specified
+     * @throws http_exception if "T" is not the type of the stored object
+     */
+    template<typename T>
+    std::shared_ptr<T> get_user_context() const {
+        auto& opts = get_request_options();
+        if (!opts.user_context) {
+            return std::shared_ptr<T>();
+        }
+        if (std::type_index(typeid(T)) != opts.user_context_type) throw http_exception(TRACEMSG(
+                "Invalid user context type requested: [" + std::string(typeid(T).name()) + "]," +
+                " stored type: [" + opts.user_context_type.name() + "]"));
+        return std::static_pointer_cast<T>(opts.user_context);
+    }
+
     /**
      * Error message, empty if no error happened.
      * 
      * @return error message
      */
     virtual const std::string& get_error() const;
+
+    /**
+     * Read-only view over the whole response body, data is owned by this resource
+     * and is not copied. Supported only by resources returned from 'polling_session::poll()'
+     * that were not written into file, body received in parts (without "Content-Length")
+     * is merged into a single buffer on the first call.
+     * 
+     * @return response body, empty if body was taken
+     */
+    virtual sl::io::span<const char> body_view();
+
+    /**
+     * Moves the response body out of this resource, memory buffer is handed over
+     * without copying (body spilled into a temporary file is copied).
+     * Supported only by resources returned from 'polling_session::poll()',
+     * 'read' returns EOF after this call.
+     * 
+     * @return response body
+     */
+    virtual std::vector<char> take_body();
  
 };
 
@@ -69,6 +69,39 @@ struct resource_info {
      * https://curl.haxx.se/libcurl/c/CURLINFO_REDIRECT_TIME.html
      */
     double redirect_time_secs = -1;
+    /**
+     * https://curl.haxx.se/libcurl/c/CURLINFO_TOTAL_TIME_T.html
+     */
+    int64_t total_time_micros = -1;
+    /**
+     * https://curl.haxx.se/libcurl/c/CURLINFO_NAMELOOKUP_TIME_T.html
+     */
+    int64_t namelookup_time_micros = -1;
+    /**
+     * https://curl.haxx.se/libcurl/c/CURLINFO_CONNECT_TIME_T.html
+     */
+    int64_t connect_time_micros = -1;
+    /**
+     * https://curl.haxx.se/libcurl/c/CURLINFO_APPCONNECT_TIME_T.html
+     */
+    int64_t appconnect_time_micros = -1;
+    /**
+     * https://curl.haxx.se/libcurl/c/CURLINFO_PRETRANSFER_TIME_T.html
+     */
+    int64_t pretransfer_time_micros = -1;
+    /**
+     * https://curl.haxx.se/libcurl/c/CURLINFO_STARTTRANSFER_TIME_T.html
+     */
+    int64_t starttransfer_time_micros = -1;
+    /**
+     * https://curl.haxx.se/libcurl/c/CURLINFO_REDIRECT_TIME_T.html
+     */
+    int64_t redirect_time_micros = -1;
+    /**
+     * https://curl.haxx.se/libcurl/c/CURLINFO_QUEUE_TIME_T.html
+     * available with cURL 8.6.0 and later
+     */
+    int64_t queue_time_micros = -1;
     /**
      * https://curl.haxx.se/libcurl/c/CURLINFO_REDIRECT_COUNT.html
      */
@@ -81,6 +114,14 @@ struct resource_info {
      * https://curl.haxx.se/libcurl/c/CURLINFO_SPEED_UPLOAD.html
      */
     double speed_upload_bytes_secs = -1;
+    /**
+     * https://curl.haxx.se/libcurl/c/CURLINFO_SIZE_DOWNLOAD_T.html
+     */
+    int64_t size_download_bytes = -1;
+    /**
+     * https://curl.haxx.se/libcurl/c/CURLINFO_SIZE_UPLOAD_T.html
+     */
+    int64_t size_upload_bytes = -1;
     /**
      * https://curl.haxx.se/libcurl/c/CURLINFO_HEADER_SIZE.html
      */
@@ -101,6 +142,16 @@ struct resource_info {
      * https://curl.haxx.se/libcurl/c/CURLINFO_NUM_CONNECTS.html
      */
     long num_connects = -1;
+    /**
+     * Whether an existing connection from the session cache was used,
+     * derived from "num_connects"
+     */
+    bool connection_reused = false;
+    /**
+     * https://curl.haxx.se/libcurl/c/CURLINFO_HTTP_VERSION.html
+     * "CURL_HTTP_VERSION_*" constant value
+     */
+    long http_version = -1;
     /**
      * https://curl.haxx.se/libcurl/c/CURLINFO_PRIMARY_IP.html
      */
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   resource_timeline.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 2:15 PM
+ */
+
+#ifndef STATICLIB_HTTP_RESOURCE_TIMELINE_HPP
+#define STATICLIB_HTTP_RESOURCE_TIMELINE_HPP
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace staticlib {
+namespace http {
+
+/**
+ * Lifecycle events of the request, recorded only when
+ * 'request_options::record_timeline' is enabled.
+ * All values are 'std::chrono::steady_clock' timestamps in nanoseconds,
+ * '-1' is used for events that did not happen (or were not recorded).
+ */
+struct resource_timeline {
+
+    /**
+     * Request was submitted to the session by the client
+     */
+    int64_t submitted = -1;
+    /**
+     * Request was taken from the session queue
+     */
+    int64_t dequeued = -1;
+    /**
+     * Easy handle was added to the cURL multi handle
+     */
+    int64_t multi_added = -1;
+    /**
+     * First response header line was received
+     */
+    int64_t first_header = -1;
+    /**
+     * First chunk of response body was received
+     */
+    int64_t first_byte = -1;
+    /**
+     * Transfer was paused because the consumer was not reading
+     * the data, and then unpaused, unpause is '-1' if the
+     * transfer was finished while paused
+     */
+    std::vector<std::pair<int64_t, int64_t>> pauses;
+    /**
+     * Transfer was finished by cURL
+     */
+    int64_t completed = -1;
+    /**
+     * Consumer received the end of the response body
+     */
+    int64_t consumer_eof = -1;
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_HTTP_RESOURCE_TIMELINE_HPP */
+
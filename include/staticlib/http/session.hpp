@@ -33,8 +33,10 @@
 #include "staticlib/pimpl.hpp"
 
 #include "staticlib/http/http_exception.hpp"
+#include "staticlib/http/request_body.hpp"
 #include "staticlib/http/resource.hpp"
 #include "staticlib/http/request_options.hpp"
+#include "staticlib/http/session_metrics.hpp"
 #include "staticlib/http/session_options.hpp"
 
 namespace staticlib {
@@ -138,6 +140,29 @@ public:
             std::unique_ptr<std::istream> post_data,
             request_options opts = request_options{}) = 0;
 
+    /**
+     * Opens specified HTTP url as a Source using POST method,
+     * body data is passed to the transfer without copying,
+     * "Content-Length" header is sent automatically
+     * 
+     * @param url HTTP URL
+     * @param body request body
+     * @param opts request options
+     * @return HTTP resource
+     */
+    virtual resource open_url(
+            const std::string& url,
+            request_body body,
+            request_options opts = request_options{}) = 0;
+
+    /**
+     * Snapshot of the session counters and latency histograms,
+     * can be called from any thread
+     * 
+     * @return session metrics
+     */
+    session_metrics get_metrics() const;
+
 };
 
 } // namespace
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   session_metrics.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 4:05 PM
+ */
+
+#ifndef STATICLIB_HTTP_SESSION_METRICS_HPP
+#define STATICLIB_HTTP_SESSION_METRICS_HPP
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace staticlib {
+namespace http {
+
+/**
+ * Log-linear latency histogram snapshot, every power of two
+ * range is split into 4 buckets, values are in microseconds
+ */
+struct latency_histogram {
+    /**
+     * Inclusive upper bound of each bucket
+     */
+    std::vector<uint64_t> bounds_micros;
+    /**
+     * Number of values recorded into each bucket
+     */
+    std::vector<uint64_t> counts;
+    /**
+     * Total number of recorded values
+     */
+    uint64_t count = 0;
+    /**
+     * Sum of all recorded values
+     */
+    uint64_t sum_micros = 0;
+
+    /**
+     * Upper bound of the bucket that contains the specified percentile
+     *
+     * @param percentile percentile value in range [0, 100]
+     * @return percentile value in microseconds, 0 if histogram is empty
+     */
+    uint64_t percentile_micros(double percentile) const;
+};
+
+/**
+ * Point-in-time view of the session counters
+ */
+struct session_metrics {
+    /**
+     * Number of requests submitted to the session
+     */
+    uint64_t requests_submitted = 0;
+    /**
+     * Number of requests finished by cURL with success
+     */
+    uint64_t requests_completed = 0;
+    /**
+     * Number of requests finished with cURL error or aborted
+     */
+    uint64_t requests_failed = 0;
+    /**
+     * Number of requests submitted and not yet finished
+     */
+    int64_t requests_in_flight = 0;
+    /**
+     * Number of requests waiting in the session queue
+     */
+    int64_t requests_queued = 0;
+    /**
+     * Number of transfers paused because consumers are not reading
+     */
+    int64_t transfers_paused = 0;
+    /**
+     * Number of response body bytes received
+     */
+    uint64_t bytes_received = 0;
+    /**
+     * Number of request body bytes sent
+     */
+    uint64_t bytes_sent = 0;
+    /**
+     * Cumulative number of new connections made by cURL for the finished
+     * requests (sum of their "num_connects"), not a number of currently
+     * open connections, reused connections are not counted
+     */
+    uint64_t new_connections = 0;
+    /**
+     * Number of finished requests by cURL error code, only non-zero entries
+     */
+    std::vector<std::pair<int, uint64_t>> errors_by_curl_code;
+    /**
+     * Distribution of the total request time
+     */
+    latency_histogram total_time;
+    /**
+     * Distribution of the time to the first response byte
+     */
+    latency_histogram ttfb;
+    /**
+     * Distribution of the time spent in cURL queue before the transfer start
+     */
+    latency_histogram queue_time;
+};
+
+/**
+ * Formats metrics using Prometheus/OpenMetrics text exposition format
+ *
+ * @param metrics metrics snapshot
+ * @param prefix metric names prefix
+ * @return metrics text
+ */
+std::string metrics_to_prometheus_text(const session_metrics& metrics,
+        const std::string& prefix = "staticlib_http");
+
+} // namespace
+}
+
+#endif /* STATICLIB_HTTP_SESSION_METRICS_HPP */
+
@@ -48,6 +48,23 @@ struct session_options {
      * Max timeout for socket 'select' call (in milliseconds)
      */
     uint16_t socket_select_max_timeout_millis = 100;
+    /**
+     * Max number of distinct request header sets, for which
+     * prepared header lists are cached for the session lifetime
+     * (least recently used set is evicted), 0 disables the cache
+     */
+    uint32_t request_headers_cache_max_size = 16;
+    /**
+     * Polling session: number of threads writing response bodies into files
+     * ("polling_response_body_file_path"), 0 means that files are written
+     * directly from the polling thread
+     */
+    uint16_t polling_file_writer_threads = 0;
+    /**
+     * Polling session: max number of response body bytes queued to file writer threads,
+     * transfers are paused while this limit is exceeded
+     */
+    uint32_t polling_file_writer_max_queued_bytes = 16 << 20;
 
     // cURL multi API options
 
@@ -70,6 +70,20 @@ public:
             const std::string& url,
             std::unique_ptr<std::istream> post_data,
             request_options options = request_options{}) override;
+
+    /**
+     * Opens specified HTTP url as a Source using POST method,
+     * body data is passed to the transfer without copying
+     * 
+     * @param url HTTP URL
+     * @param body request body
+     * @param options request options
+     * @return HTTP resource
+     */
+    virtual resource open_url(
+            const std::string& url,
+            request_body body,
+            request_options options = request_options{}) override;
 };
 
 } // namespace
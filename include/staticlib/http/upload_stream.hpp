@@ -0,0 +1,114 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   upload_stream.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 8:25 PM
+ */
+
+#ifndef STATICLIB_HTTP_UPLOAD_STREAM_HPP
+#define STATICLIB_HTTP_UPLOAD_STREAM_HPP
+
+#include <cstdint>
+#include <ios>
+#include <memory>
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/pimpl.hpp"
+
+#include "staticlib/http/http_exception.hpp"
+
+namespace staticlib {
+namespace http {
+
+// forward decl
+class upload_pipe;
+
+/**
+ * Request body that is pushed by the client from its own thread,
+ * can be used as a `Sink`. Request body is sent with chunked
+ * encoding until the stream is closed, transfer is paused
+ * (without blocking other transfers) when no data is available.
+ * Destroying the stream without closing it aborts the request.
+ */
+class upload_stream : public sl::pimpl::object {
+protected:
+    /**
+     * implementation class
+     */
+    class impl;
+
+    friend std::shared_ptr<upload_pipe> get_upload_pipe(upload_stream& stream);
+
+public:
+    /**
+     * PIMPL-specific constructor
+     *
+     * @param pimpl impl object
+     */
+    PIMPL_CONSTRUCTOR(upload_stream)
+
+    /**
+     * Constructor
+     *
+     * @param max_chunks max number of written chunks that are not yet sent
+     */
+    upload_stream(uint16_t max_chunks = 16);
+
+    /**
+     * Writes a copy of the specified data as a single chunk,
+     * blocks while the stream is full
+     *
+     * @param span data to write
+     * @return number of bytes written
+     */
+    std::streamsize write(sl::io::span<const char> span);
+
+    /**
+     * Writes a copy of the specified data as a single chunk,
+     * never blocks
+     *
+     * @param span data to write
+     * @return false if the stream is full and nothing was written
+     */
+    bool try_write(sl::io::span<const char> span);
+
+    /**
+     * No-op, all written data is passed to the sender immediately
+     *
+     * @return zero
+     */
+    std::streamsize flush();
+
+    /**
+     * Marks the end of the request body
+     */
+    void close();
+
+    /**
+     * Aborts the request
+     */
+    void abort();
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_HTTP_UPLOAD_STREAM_HPP */
+
@@ -0,0 +1,169 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   async_file_writer.cpp
+ * Author: alex
+ *
+ * Created on October 19, 2026, 1:55 AM
+ */
+
+#include "async_file_writer.hpp"
+
+#include <exception>
+
+#include "staticlib/support.hpp"
+
+namespace staticlib {
+namespace http {
+
+async_file_writer::async_file_writer(uint16_t threads_count, uint64_t max_queued_bytes) :
+queued_bytes(0),
+max_queued_bytes(max_queued_bytes) {
+    if (0 == threads_count) throw http_exception(TRACEMSG(
+            "Invalid zero threads count specified for file writer"));
+    for (uint16_t i = 0; i < threads_count; i++) {
+        threads.emplace_back([this] {
+            this->worker_proc();
+        });
+    }
+}
+
+async_file_writer::~async_file_writer() STATICLIB_NOEXCEPT {
+    {
+        std::lock_guard<std::mutex> guard{mutex};
+        stopping = true;
+    }
+    jobs_cv.notify_all();
+    for (auto& th : threads) {
+        th.join();
+    }
+}
+
+void async_file_writer::write(const std::shared_ptr<async_file_stream>& stream, std::vector<char>&& data) {
+    if (data.empty()) return;
+    std::unique_lock<std::mutex> lock{mutex};
+    if (stream->closed) throw http_exception(TRACEMSG("Invalid write into closed file stream"));
+    auto jo = job();
+    jo.stream = stream;
+    jo.offset = stream->next_offset;
+    jo.data = std::move(data);
+    stream->next_offset += jo.data.size();
+    queued_bytes.fetch_add(jo.data.size(), std::memory_order_acq_rel);
+    enqueue(lock, std::move(jo));
+}
+
+void async_file_writer::close(const std::shared_ptr<async_file_stream>& stream, bool sync) {
+    std::unique_lock<std::mutex> lock{mutex};
+    if (stream->closed) return;
+    stream->closed = true;
+    stream->sync_on_close = sync;
+    if (stream->pending_jobs > 0) {
+        // last write job completes the stream
+        return;
+    }
+    if (sync) {
+        // empty job, flush is done by the worker
+        auto jo = job();
+        jo.stream = stream;
+        jo.offset = stream->next_offset;
+        enqueue(lock, std::move(jo));
+    } else {
+        stream->complete = true;
+    }
+}
+
+bool async_file_writer::is_complete(const std::shared_ptr<async_file_stream>& stream) {
+    std::lock_guard<std::mutex> guard{mutex};
+    return stream->complete;
+}
+
+std::string async_file_writer::get_error(const std::shared_ptr<async_file_stream>& stream) {
+    std::lock_guard<std::mutex> guard{mutex};
+    return stream->error;
+}
+
+void async_file_writer::await_completion(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock{mutex};
+    completion_cv.wait_for(lock, timeout);
+}
+
+void async_file_writer::enqueue(std::unique_lock<std::mutex>& lock, job&& jo) {
+    jo.stream->pending_jobs += 1;
+    jobs.emplace_back(std::move(jo));
+    lock.unlock();
+    jobs_cv.notify_one();
+}
+
+void async_file_writer::worker_proc() {
+    for (;;) {
+        auto jo = job();
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            jobs_cv.wait(lock, [this] {
+                return stopping || !jobs.empty();
+            });
+            if (jobs.empty()) {
+                return;
+            }
+            jo = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        auto& st = *jo.stream;
+        auto err = std::string();
+        try {
+            if (!jo.data.empty()) {
+                // jobs of the same stream write disjoint ranges
+                st.sink.write_at({jo.data.data(), jo.data.size()}, jo.offset);
+            }
+        } catch (const std::exception& e) {
+            err = e.what();
+        }
+        queued_bytes.fetch_sub(jo.data.size(), std::memory_order_acq_rel);
+        bool do_sync = false;
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            if (!err.empty() && st.error.empty()) {
+                st.error = err;
+            }
+            st.pending_jobs -= 1;
+            if (0 == st.pending_jobs && st.closed) {
+                if (st.sync_on_close && st.error.empty()) {
+                    do_sync = true;
+                } else {
+                    st.complete = true;
+                }
+            }
+        }
+        if (do_sync) {
+            // other jobs of this stream are finished, stream is closed
+            try {
+                st.sink.sync();
+            } catch (const std::exception& e) {
+                err = e.what();
+            }
+            std::lock_guard<std::mutex> guard{mutex};
+            if (!err.empty() && st.error.empty()) {
+                st.error = err;
+            }
+            st.complete = true;
+        }
+        completion_cv.notify_all();
+    }
+}
+
+} // namespace
+}
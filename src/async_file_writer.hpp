@@ -0,0 +1,125 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   async_file_writer.hpp
+ * Author: alex
+ *
+ * Created on October 19, 2026, 1:40 AM
+ */
+
+#ifndef STATICLIB_HTTP_ASYNC_FILE_WRITER_HPP
+#define STATICLIB_HTTP_ASYNC_FILE_WRITER_HPP
+
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "staticlib/config.hpp"
+
+#include "positional_file_sink.hpp"
+
+namespace staticlib {
+namespace http {
+
+// response body file written by the writer threads, state
+// is guarded by the writer mutex, file is closed when
+// the last job and the owning request are destroyed
+class async_file_stream {
+    friend class async_file_writer;
+
+    positional_file_sink sink;
+    uint64_t next_offset;
+    size_t pending_jobs = 0;
+    bool closed = false;
+    bool sync_on_close = false;
+    bool complete = false;
+    std::string error;
+
+public:
+    async_file_stream(const std::string& path, uint64_t offset) :
+    sink(path, offset),
+    next_offset(offset) { }
+
+    async_file_stream(const async_file_stream&) = delete;
+
+    async_file_stream& operator=(const async_file_stream&) = delete;
+};
+
+// pool of threads writing queued chunks with positional writes,
+// polling thread pauses transfers while queued bytes exceed the limit
+class async_file_writer {
+    struct job {
+        std::shared_ptr<async_file_stream> stream;
+        uint64_t offset;
+        std::vector<char> data;
+    };
+
+    std::mutex mutex;
+    std::condition_variable jobs_cv;
+    std::condition_variable completion_cv;
+    std::deque<job> jobs;
+    std::atomic<uint64_t> queued_bytes;
+    uint64_t max_queued_bytes;
+    bool stopping = false;
+    std::vector<std::thread> threads;
+
+public:
+    async_file_writer(uint16_t threads_count, uint64_t max_queued_bytes);
+
+    // queued jobs are written before threads exit
+    ~async_file_writer() STATICLIB_NOEXCEPT;
+
+    async_file_writer(const async_file_writer&) = delete;
+
+    async_file_writer& operator=(const async_file_writer&) = delete;
+
+    bool has_capacity() const {
+        return queued_bytes.load(std::memory_order_acquire) < max_queued_bytes;
+    }
+
+    // data is appended to the stream
+    void write(const std::shared_ptr<async_file_stream>& stream, std::vector<char>&& data);
+
+    // no more writes, stream becomes complete after all queued
+    // data is written (and flushed to disk if requested)
+    void close(const std::shared_ptr<async_file_stream>& stream, bool sync);
+
+    bool is_complete(const std::shared_ptr<async_file_stream>& stream);
+
+    // first write error, empty if none
+    std::string get_error(const std::shared_ptr<async_file_stream>& stream);
+
+    // returns when any stream is complete or on timeout
+    void await_completion(std::chrono::milliseconds timeout);
+
+private:
+    void worker_proc();
+
+    void enqueue(std::unique_lock<std::mutex>& lock, job&& jo);
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_HTTP_ASYNC_FILE_WRITER_HPP */
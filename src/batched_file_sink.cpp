@@ -0,0 +1,223 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   batched_file_sink.cpp
+ * Author: alex
+ *
+ * Created on October 19, 2026, 1:05 AM
+ */
+
+#include "batched_file_sink.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+
+#ifdef STATICLIB_WINDOWS
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif // NOMINMAX
+#include <malloc.h>
+#include <windows.h>
+#else // !STATICLIB_WINDOWS
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif // STATICLIB_WINDOWS
+
+#include "staticlib/support.hpp"
+
+namespace staticlib {
+namespace http {
+
+namespace { // anonymous
+
+// covers logical block size of common disks, required for direct IO
+const size_t block_size = 4096;
+
+size_t align_up(size_t len) {
+    return (len + block_size - 1) / block_size * block_size;
+}
+
+} // namespace
+
+#ifdef STATICLIB_WINDOWS
+
+batched_file_sink::batched_file_sink(const std::string& path, uint32_t batch_size, bool direct_io) :
+handle(reinterpret_cast<intptr_t> (INVALID_HANDLE_VALUE)),
+path(path.data(), path.length()),
+direct_io(direct_io),
+batch_size(align_up(std::max(batch_size, static_cast<uint32_t> (1)))) {
+    DWORD flags = direct_io ? FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH : FILE_FLAG_SEQUENTIAL_SCAN;
+    HANDLE ha = ::CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, NULL,
+            CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | flags, NULL);
+    if (INVALID_HANDLE_VALUE == ha) throw http_exception(TRACEMSG(
+            "Error opening file for writing, path: [" + path + "]," +
+            " error: [" + sl::support::to_string(::GetLastError()) + "]"));
+    this->buffer = static_cast<char*> (::_aligned_malloc(this->batch_size, block_size));
+    if (nullptr == buffer) {
+        ::CloseHandle(ha);
+        throw http_exception(TRACEMSG("Error allocating file buffer, path: [" + path + "]," +
+                " size: [" + sl::support::to_string(this->batch_size) + "]"));
+    }
+    this->handle = reinterpret_cast<intptr_t> (ha);
+}
+
+batched_file_sink::~batched_file_sink() STATICLIB_NOEXCEPT {
+    ::_aligned_free(buffer);
+    ::CloseHandle(reinterpret_cast<HANDLE> (handle));
+}
+
+void batched_file_sink::write_batch(size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        auto chunk = static_cast<DWORD> (std::min(len - done,
+                static_cast<size_t> (std::numeric_limits<DWORD>::max()) / block_size * block_size));
+        DWORD res = 0;
+        auto success = ::WriteFile(reinterpret_cast<HANDLE> (handle), buffer + done,
+                chunk, std::addressof(res), NULL);
+        if (0 == success) throw http_exception(TRACEMSG(
+                "Error writing file, path: [" + path + "]," +
+                " offset: [" + sl::support::to_string(written + done) + "]," +
+                " error: [" + sl::support::to_string(::GetLastError()) + "]"));
+        done += res;
+    }
+}
+
+void batched_file_sink::finish() {
+    if (0 == buffered) return;
+    size_t len = buffered;
+    if (direct_io) {
+        len = align_up(buffered);
+        std::memset(buffer + buffered, '\0', len - buffered);
+    }
+    write_batch(len);
+    written += buffered;
+    buffered = 0;
+    if (direct_io) {
+        LARGE_INTEGER pos;
+        pos.QuadPart = static_cast<LONGLONG> (written);
+        auto ha = reinterpret_cast<HANDLE> (handle);
+        if (!::SetFilePointerEx(ha, pos, NULL, FILE_BEGIN) || !::SetEndOfFile(ha)) throw http_exception(TRACEMSG(
+                "Error truncating file, path: [" + path + "]," +
+                " size: [" + sl::support::to_string(written) + "]," +
+                " error: [" + sl::support::to_string(::GetLastError()) + "]"));
+    }
+}
+
+#else // !STATICLIB_WINDOWS
+
+batched_file_sink::batched_file_sink(const std::string& path, uint32_t batch_size, bool direct_io) :
+handle(-1),
+path(path.data(), path.length()),
+direct_io(direct_io),
+batch_size(align_up(std::max(batch_size, static_cast<uint32_t> (1)))) {
+    int flags = O_WRONLY | O_CREAT | O_TRUNC;
+    int fd = -1;
+#ifdef O_DIRECT
+    if (direct_io) {
+        fd = ::open(path.c_str(), flags | O_DIRECT, 0644);
+        // not supported by the file system (e.g. tmpfs)
+        if (-1 == fd && EINVAL == errno) {
+            this->direct_io = false;
+        }
+    }
+#else // !O_DIRECT
+    this->direct_io = false;
+#endif // O_DIRECT
+    if (-1 == fd) {
+        fd = ::open(path.c_str(), flags, 0644);
+    }
+    if (-1 == fd) throw http_exception(TRACEMSG(
+            "Error opening file for writing, path: [" + path + "]," +
+            " error: [" + ::strerror(errno) + "]"));
+#ifdef STATICLIB_MAC
+    if (direct_io) {
+        // hint only, failure is not an error
+        ::fcntl(fd, F_NOCACHE, 1);
+    }
+#endif // STATICLIB_MAC
+    void* buf = nullptr;
+    int err = ::posix_memalign(std::addressof(buf), block_size, this->batch_size);
+    if (0 != err) {
+        ::close(fd);
+        throw http_exception(TRACEMSG("Error allocating file buffer, path: [" + path + "]," +
+                " size: [" + sl::support::to_string(this->batch_size) + "]," +
+                " error: [" + ::strerror(err) + "]"));
+    }
+    this->buffer = static_cast<char*> (buf);
+    this->handle = static_cast<intptr_t> (fd);
+}
+
+batched_file_sink::~batched_file_sink() STATICLIB_NOEXCEPT {
+    std::free(buffer);
+    ::close(static_cast<int> (handle));
+}
+
+void batched_file_sink::write_batch(size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        auto res = ::write(static_cast<int> (handle), buffer + done, len - done);
+        if (-1 == res) {
+            if (EINTR == errno) continue;
+            throw http_exception(TRACEMSG("Error writing file, path: [" + path + "]," +
+                    " offset: [" + sl::support::to_string(written + done) + "]," +
+                    " error: [" + ::strerror(errno) + "]"));
+        }
+        done += static_cast<size_t> (res);
+    }
+}
+
+void batched_file_sink::finish() {
+    if (0 == buffered) return;
+    size_t len = buffered;
+    if (direct_io) {
+        len = align_up(buffered);
+        std::memset(buffer + buffered, '\0', len - buffered);
+    }
+    write_batch(len);
+    written += buffered;
+    buffered = 0;
+    if (direct_io && -1 == ::ftruncate(static_cast<int> (handle), static_cast<off_t> (written))) {
+        throw http_exception(TRACEMSG("Error truncating file, path: [" + path + "]," +
+                " size: [" + sl::support::to_string(written) + "]," +
+                " error: [" + ::strerror(errno) + "]"));
+    }
+}
+
+#endif // STATICLIB_WINDOWS
+
+std::streamsize batched_file_sink::write(sl::io::span<const char> span) {
+    size_t copied = 0;
+    while (copied < span.size()) {
+        size_t len = std::min(span.size() - copied, batch_size - buffered);
+        std::memcpy(buffer + buffered, span.data() + copied, len);
+        buffered += len;
+        copied += len;
+        if (batch_size == buffered) {
+            write_batch(batch_size);
+            written += batch_size;
+            buffered = 0;
+        }
+    }
+    return static_cast<std::streamsize> (copied);
+}
+
+} // namespace
+}
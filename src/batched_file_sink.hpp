@@ -0,0 +1,83 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   batched_file_sink.hpp
+ * Author: alex
+ *
+ * Created on October 19, 2026, 12:50 AM
+ */
+
+#ifndef STATICLIB_HTTP_BATCHED_FILE_SINK_HPP
+#define STATICLIB_HTTP_BATCHED_FILE_SINK_HPP
+
+#include <cstdint>
+#include <ios>
+#include <string>
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+
+#include "staticlib/http/http_exception.hpp"
+
+namespace staticlib {
+namespace http {
+
+// creates (or truncates) the file and writes it sequentially in batches
+// of the fixed size from the block-aligned buffer, with direct IO
+// the page cache is bypassed where supported, the last batch is
+// padded to the block size and the file is truncated on 'finish'
+class batched_file_sink {
+    // fd or HANDLE
+    intptr_t handle;
+    std::string path;
+    bool direct_io;
+    size_t batch_size;
+    char* buffer = nullptr;
+    size_t buffered = 0;
+    uint64_t written = 0;
+
+public:
+    batched_file_sink(const std::string& path, uint32_t batch_size, bool direct_io);
+
+    ~batched_file_sink() STATICLIB_NOEXCEPT;
+
+    batched_file_sink(const batched_file_sink&) = delete;
+
+    batched_file_sink& operator=(const batched_file_sink&) = delete;
+
+    std::streamsize write(sl::io::span<const char> span);
+
+    std::streamsize flush() {
+        return 0;
+    }
+
+    // writes the buffered tail, must be called once
+    // after the last write, otherwise tail is lost
+    void finish();
+
+    uint64_t get_written_bytes() const {
+        return written + buffered;
+    }
+
+private:
+    void write_batch(size_t len);
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_HTTP_BATCHED_FILE_SINK_HPP */
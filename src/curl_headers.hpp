@@ -36,47 +36,81 @@
 #include "staticlib/http/request_options.hpp"
 
 #include "curl_deleters.hpp"
+#include "curl_headers_cache.hpp"
 
 namespace staticlib {
 namespace http {
 
 class curl_headers {
+    sl::support::observer_ptr<curl_headers_cache> cache;
+    // immutable, may be shared with other requests
+    std::shared_ptr<struct curl_slist> shared_slist;
+    // per-request headers are linked in front of the shared list,
+    // these nodes are owned here and are never freed by curl
     std::vector<std::string> stored_headers;
-    std::unique_ptr<struct curl_slist, curl_slist_deleter> slist;
+    std::vector<struct curl_slist> nodes;
 
 public:
-    curl_headers() { }
-    
+    curl_headers(curl_headers_cache& cache) :
+    cache(sl::support::make_observer_ptr(cache)) { }
+
     curl_headers(const curl_headers&) = delete;
 
     curl_headers& operator=(const curl_headers&) = delete;
 
     curl_headers(curl_headers&& other) :
+    cache(other.cache),
+    shared_slist(std::move(other.shared_slist)),
     stored_headers(std::move(other.stored_headers)),
-    slist(std::move(other.slist)) { }
+    nodes(std::move(other.nodes)) { }
 
     curl_headers& operator=(curl_headers&& other) {
+        cache = other.cache;
+        shared_slist = std::move(other.shared_slist);
         stored_headers = std::move(other.stored_headers);
-        slist = std::move(other.slist);
+        nodes = std::move(other.nodes);
         return *this;
     }
 
     sl::support::optional<curl_slist*> wrap_into_slist(
-            const std::vector<std::pair<std::string, std::string>>& provided_headers) {
-        for (auto& pa : provided_headers) {
-            stored_headers.emplace_back(pa.first + ": " + pa.second);
-            curl_slist* released = slist.release();
-            curl_slist* ptr = curl_slist_append(released, stored_headers.back().c_str());
-            if (nullptr == ptr) throw http_exception(TRACEMSG(
-                    "Error appending header, key: [" + pa.first + "]," +
-                    " value: [" + pa.second + "]," +
-                    " appended count: [" + sl::support::to_string(stored_headers.size()) + "]"));
-            slist.reset(ptr);
+            const std::vector<std::pair<std::string, std::string>>& provided_headers,
+            const std::vector<std::pair<std::string, std::string>>& dynamic_headers,
+            bool send_chunked, bool suppress_expect) {
+        this->shared_slist = cache->get_or_build(provided_headers);
+        size_t count = dynamic_headers.size() + (send_chunked ? 1 : 0) + (suppress_expect ? 1 : 0);
+        if (0 == count) {
+            if (nullptr != shared_slist.get()) {
+                return sl::support::make_optional(shared_slist.get());
+            }
+            return sl::support::optional<curl_slist*>();
+        }
+        // all strings must be in place before taking pointers to them
+        stored_headers.reserve(dynamic_headers.size());
+        for (auto& pa : dynamic_headers) {
+            std::string line;
+            line.reserve(pa.first.length() + pa.second.length() + 2);
+            line.append(pa.first).append(": ").append(pa.second);
+            stored_headers.emplace_back(std::move(line));
+        }
+        nodes.resize(count);
+        for (size_t i = 0; i < stored_headers.size(); i++) {
+            nodes[i].data = const_cast<char*> (stored_headers[i].c_str());
+        }
+        size_t idx = stored_headers.size();
+        if (send_chunked) {
+            static char chunked[] = "Transfer-Encoding: chunked";
+            nodes[idx++].data = chunked;
+        }
+        if (suppress_expect) {
+            // empty value removes the header added by cURL
+            static char expect[] = "Expect:";
+            nodes[idx++].data = expect;
         }
-        if (nullptr != slist.get()) {
-            return sl::support::make_optional(slist.get());
+        for (size_t i = 0; i < nodes.size() - 1; i++) {
+            nodes[i].next = std::addressof(nodes[i + 1]);
         }
-        return sl::support::optional<curl_slist*>();
+        nodes.back().next = shared_slist.get();
+        return sl::support::make_optional(std::addressof(nodes.front()));
     }
 };
 
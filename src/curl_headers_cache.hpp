@@ -0,0 +1,152 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   curl_headers_cache.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 11:02 AM
+ */
+
+#ifndef STATICLIB_HTTP_CURL_HEADERS_CACHE_HPP
+#define STATICLIB_HTTP_CURL_HEADERS_CACHE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "curl/curl.h"
+
+#include "staticlib/config.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/http/http_exception.hpp"
+
+#include "curl_deleters.hpp"
+
+namespace staticlib {
+namespace http {
+
+// Prepared header lists are immutable after creation and are shared
+// between all requests of the session that send the same header set.
+// Not thread-safe, must be used only from the thread that applies
+// the options to the easy handles.
+class curl_headers_cache {
+    using headers_type = std::vector<std::pair<std::string, std::string>>;
+
+    struct entry {
+        size_t hash;
+        headers_type headers;
+        std::shared_ptr<struct curl_slist> slist;
+        uint64_t last_used;
+
+        entry(size_t hash, const headers_type& headers,
+                std::shared_ptr<struct curl_slist> slist, uint64_t last_used) :
+        hash(hash),
+        headers(headers),
+        slist(std::move(slist)),
+        last_used(last_used) { }
+    };
+
+    std::vector<entry> entries;
+    uint32_t max_size;
+    uint64_t tick = 0;
+
+public:
+    curl_headers_cache(uint32_t max_size) :
+    max_size(max_size) { }
+
+    curl_headers_cache(const curl_headers_cache&) = delete;
+
+    curl_headers_cache& operator=(const curl_headers_cache&) = delete;
+
+    std::shared_ptr<struct curl_slist> get_or_build(const headers_type& headers) {
+        if (headers.empty()) {
+            return std::shared_ptr<struct curl_slist>();
+        }
+        if (0 == max_size) {
+            return build_slist(headers);
+        }
+        tick += 1;
+        size_t hash = hash_headers(headers);
+        for (auto& en : entries) {
+            if (hash == en.hash && headers == en.headers) {
+                en.last_used = tick;
+                return en.slist;
+            }
+        }
+        auto slist = build_slist(headers);
+        if (entries.size() < max_size) {
+            entries.emplace_back(hash, headers, slist, tick);
+        } else {
+            // replace least recently used, requests, that
+            // are still running, keep their own references
+            auto lru = entries.begin();
+            for (auto it = entries.begin(); it != entries.end(); ++it) {
+                if (it->last_used < lru->last_used) {
+                    lru = it;
+                }
+            }
+            *lru = entry(hash, headers, slist, tick);
+        }
+        return slist;
+    }
+
+    size_t size() const {
+        return entries.size();
+    }
+
+private:
+    static size_t hash_headers(const headers_type& headers) {
+        auto hasher = std::hash<std::string>();
+        size_t res = headers.size();
+        for (auto& pa : headers) {
+            res = res * 31 + hasher(pa.first);
+            res = res * 31 + hasher(pa.second);
+        }
+        return res;
+    }
+
+    static std::shared_ptr<struct curl_slist> build_slist(const headers_type& headers) {
+        auto slist = std::unique_ptr<struct curl_slist, curl_slist_deleter>();
+        std::string line;
+        for (auto& pa : headers) {
+            line.clear();
+            line.reserve(pa.first.length() + pa.second.length() + 2);
+            line.append(pa.first).append(": ").append(pa.second);
+            curl_slist* released = slist.release();
+            // string is copied by curl
+            curl_slist* ptr = curl_slist_append(released, line.c_str());
+            if (nullptr == ptr) {
+                curl_slist_free_all(released);
+                throw http_exception(TRACEMSG(
+                        "Error appending header, key: [" + pa.first + "]," +
+                        " value: [" + pa.second + "]"));
+            }
+            slist.reset(ptr);
+        }
+        return std::shared_ptr<struct curl_slist>(slist.release(), curl_slist_deleter());
+    }
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_HTTP_CURL_HEADERS_CACHE_HPP */
+
@@ -25,13 +25,16 @@
 #define STATICLIB_HTTP_CURL_INFO_HPP
 
 #include <cstdint>
-#include <cstdint>
+#include <cstring>
+#include <array>
+#include <string>
 
 #include "curl/curl.h"
 
 #include "staticlib/config.hpp"
 
 #include "staticlib/http/http_exception.hpp"
+#include "staticlib/http/resource_info.hpp"
 
 namespace staticlib {
 namespace http {
@@ -66,40 +69,204 @@ public:
     }
 
     std::string getinfo_string(CURLINFO opt) {
+        return std::string(getinfo_cstr(opt));
+    }
+
+    const char* getinfo_cstr(CURLINFO opt) {
         char* out = nullptr;
         CURLcode err = curl_easy_getinfo(handle, opt, std::addressof(out));
         if (err != CURLE_OK) throw http_exception(TRACEMSG(
                 "cURL curl_easy_getinfo error: [" + curl_easy_strerror(err) + "]," +
                 " option: [" + sl::support::to_string(opt) + "]"));
-        return std::string(out);
+        return nullptr != out ? out : "";
+    }
+
+    curl_off_t getinfo_off_t(CURLINFO opt) {
+        curl_off_t out = -1;
+        CURLcode err = curl_easy_getinfo(handle, opt, std::addressof(out));
+        if (err != CURLE_OK) throw http_exception(TRACEMSG(
+                "cURL curl_easy_getinfo error: [" + curl_easy_strerror(err) + "]," +
+                " option: [" + sl::support::to_string(opt) + "]"));
+        return out;
     }
 
 };
 
-inline resource_info curl_collect_info(CURL* handle) {
-    resource_info info;
-    curl_info ci(handle);
-    info.effective_url = ci.getinfo_string(CURLINFO_EFFECTIVE_URL);
-    info.total_time_secs = ci.getinfo_double(CURLINFO_TOTAL_TIME);
-    info.namelookup_time_secs = ci.getinfo_double(CURLINFO_NAMELOOKUP_TIME);
-    info.connect_time_secs = ci.getinfo_double(CURLINFO_CONNECT_TIME);
-    info.appconnect_time_secs = ci.getinfo_double(CURLINFO_APPCONNECT_TIME);
-    info.pretransfer_time_secs = ci.getinfo_double(CURLINFO_PRETRANSFER_TIME);
-    info.starttransfer_time_secs = ci.getinfo_double(CURLINFO_STARTTRANSFER_TIME);
-    info.redirect_time_secs = ci.getinfo_double(CURLINFO_REDIRECT_TIME);
-    info.redirect_count = ci.getinfo_long(CURLINFO_REDIRECT_COUNT);
-    info.speed_download_bytes_secs = ci.getinfo_double(CURLINFO_SPEED_DOWNLOAD);
-    info.speed_upload_bytes_secs = ci.getinfo_double(CURLINFO_SPEED_UPLOAD);
-    info.header_size_bytes = ci.getinfo_long(CURLINFO_HEADER_SIZE);
-    info.request_size_bytes = ci.getinfo_long(CURLINFO_REQUEST_SIZE);
-    info.ssl_verifyresult = ci.getinfo_long(CURLINFO_SSL_VERIFYRESULT);
-    info.os_errno = ci.getinfo_long(CURLINFO_OS_ERRNO);
-    info.num_connects = ci.getinfo_long(CURLINFO_NUM_CONNECTS);
-    info.primary_ip = ci.getinfo_string(CURLINFO_PRIMARY_IP);
-    info.primary_port = ci.getinfo_long(CURLINFO_PRIMARY_PORT);
-    return info;
-}
+// compact raw values, conversion to resource_info
+// is done only when info is requested by the client
+class curl_info_snapshot {
+    // microseconds
+    curl_off_t total_time = -1;
+    curl_off_t namelookup_time = -1;
+    curl_off_t connect_time = -1;
+    curl_off_t appconnect_time = -1;
+    curl_off_t pretransfer_time = -1;
+    curl_off_t starttransfer_time = -1;
+    curl_off_t redirect_time = -1;
+    curl_off_t queue_time = -1;
+    // bytes
+    curl_off_t speed_download = -1;
+    curl_off_t speed_upload = -1;
+    curl_off_t size_download = -1;
+    curl_off_t size_upload = -1;
+    long redirect_count = -1;
+    long header_size = -1;
+    long request_size = -1;
+    long ssl_verifyresult = -1;
+    long os_errno = -1;
+    long num_connects = -1;
+    long http_version = -1;
+    long primary_port = -1;
+    std::array<char, 48> primary_ip;
+    // empty if the same as request URL
+    std::string effective_url;
+    bool collected = false;
+
+public:
+    curl_info_snapshot() {
+        primary_ip[0] = '\0';
+    }
+
+    void collect(CURL* handle, const std::string& url) {
+        curl_info ci(handle);
+#if LIBCURL_VERSION_NUM >= 0x073d00
+        total_time = ci.getinfo_off_t(CURLINFO_TOTAL_TIME_T);
+        namelookup_time = ci.getinfo_off_t(CURLINFO_NAMELOOKUP_TIME_T);
+        connect_time = ci.getinfo_off_t(CURLINFO_CONNECT_TIME_T);
+        appconnect_time = ci.getinfo_off_t(CURLINFO_APPCONNECT_TIME_T);
+        pretransfer_time = ci.getinfo_off_t(CURLINFO_PRETRANSFER_TIME_T);
+        starttransfer_time = ci.getinfo_off_t(CURLINFO_STARTTRANSFER_TIME_T);
+        redirect_time = ci.getinfo_off_t(CURLINFO_REDIRECT_TIME_T);
+#else // older cURL, double seconds only
+        total_time = secs_to_micros(ci.getinfo_double(CURLINFO_TOTAL_TIME));
+        namelookup_time = secs_to_micros(ci.getinfo_double(CURLINFO_NAMELOOKUP_TIME));
+        connect_time = secs_to_micros(ci.getinfo_double(CURLINFO_CONNECT_TIME));
+        appconnect_time = secs_to_micros(ci.getinfo_double(CURLINFO_APPCONNECT_TIME));
+        pretransfer_time = secs_to_micros(ci.getinfo_double(CURLINFO_PRETRANSFER_TIME));
+        starttransfer_time = secs_to_micros(ci.getinfo_double(CURLINFO_STARTTRANSFER_TIME));
+        redirect_time = secs_to_micros(ci.getinfo_double(CURLINFO_REDIRECT_TIME));
+#endif // LIBCURL_VERSION_NUM
+        // Added in 8.6.0
+#if LIBCURL_VERSION_NUM >= 0x080600
+        queue_time = ci.getinfo_off_t(CURLINFO_QUEUE_TIME_T);
+#endif // LIBCURL_VERSION_NUM
+        // Added in 7.55.0
+#if LIBCURL_VERSION_NUM >= 0x073700
+        speed_download = ci.getinfo_off_t(CURLINFO_SPEED_DOWNLOAD_T);
+        speed_upload = ci.getinfo_off_t(CURLINFO_SPEED_UPLOAD_T);
+        size_download = ci.getinfo_off_t(CURLINFO_SIZE_DOWNLOAD_T);
+        size_upload = ci.getinfo_off_t(CURLINFO_SIZE_UPLOAD_T);
+#else
+        speed_download = static_cast<curl_off_t> (ci.getinfo_double(CURLINFO_SPEED_DOWNLOAD));
+        speed_upload = static_cast<curl_off_t> (ci.getinfo_double(CURLINFO_SPEED_UPLOAD));
+        size_download = static_cast<curl_off_t> (ci.getinfo_double(CURLINFO_SIZE_DOWNLOAD));
+        size_upload = static_cast<curl_off_t> (ci.getinfo_double(CURLINFO_SIZE_UPLOAD));
+#endif // LIBCURL_VERSION_NUM
+        redirect_count = ci.getinfo_long(CURLINFO_REDIRECT_COUNT);
+        header_size = ci.getinfo_long(CURLINFO_HEADER_SIZE);
+        request_size = ci.getinfo_long(CURLINFO_REQUEST_SIZE);
+        ssl_verifyresult = ci.getinfo_long(CURLINFO_SSL_VERIFYRESULT);
+        os_errno = ci.getinfo_long(CURLINFO_OS_ERRNO);
+        num_connects = ci.getinfo_long(CURLINFO_NUM_CONNECTS);
+        // Added in 7.50.0
+#if LIBCURL_VERSION_NUM >= 0x073200
+        http_version = ci.getinfo_long(CURLINFO_HTTP_VERSION);
+#endif // LIBCURL_VERSION_NUM
+        primary_port = ci.getinfo_long(CURLINFO_PRIMARY_PORT);
+        // no copies for strings that are not needed
+        const char* ip = ci.getinfo_cstr(CURLINFO_PRIMARY_IP);
+        std::strncpy(primary_ip.data(), ip, primary_ip.size() - 1);
+        primary_ip[primary_ip.size() - 1] = '\0';
+        const char* eurl = ci.getinfo_cstr(CURLINFO_EFFECTIVE_URL);
+        if (0 != url.compare(eurl)) {
+            effective_url = std::string(eurl);
+        }
+        collected = true;
+    }
+
+    bool is_collected() const {
+        return collected;
+    }
+
+    int64_t get_total_time_micros() const {
+        return static_cast<int64_t> (total_time);
+    }
+
+    int64_t get_starttransfer_time_micros() const {
+        return static_cast<int64_t> (starttransfer_time);
+    }
+
+    int64_t get_queue_time_micros() const {
+        return static_cast<int64_t> (queue_time);
+    }
 
+    int64_t get_size_download_bytes() const {
+        return static_cast<int64_t> (size_download);
+    }
+
+    int64_t get_size_upload_bytes() const {
+        return static_cast<int64_t> (size_upload);
+    }
+
+    long get_num_connects() const {
+        return num_connects;
+    }
+
+    resource_info to_resource_info(const std::string& url) const {
+        resource_info info;
+        if (!collected) {
+            return info;
+        }
+        info.effective_url = effective_url.empty() ? url : effective_url;
+        info.total_time_micros = static_cast<int64_t> (total_time);
+        info.namelookup_time_micros = static_cast<int64_t> (namelookup_time);
+        info.connect_time_micros = static_cast<int64_t> (connect_time);
+        info.appconnect_time_micros = static_cast<int64_t> (appconnect_time);
+        info.pretransfer_time_micros = static_cast<int64_t> (pretransfer_time);
+        info.starttransfer_time_micros = static_cast<int64_t> (starttransfer_time);
+        info.redirect_time_micros = static_cast<int64_t> (redirect_time);
+        info.queue_time_micros = static_cast<int64_t> (queue_time);
+        info.total_time_secs = micros_to_secs(total_time);
+        info.namelookup_time_secs = micros_to_secs(namelookup_time);
+        info.connect_time_secs = micros_to_secs(connect_time);
+        info.appconnect_time_secs = micros_to_secs(appconnect_time);
+        info.pretransfer_time_secs = micros_to_secs(pretransfer_time);
+        info.starttransfer_time_secs = micros_to_secs(starttransfer_time);
+        info.redirect_time_secs = micros_to_secs(redirect_time);
+        info.redirect_count = redirect_count;
+        info.speed_download_bytes_secs = static_cast<double> (speed_download);
+        info.speed_upload_bytes_secs = static_cast<double> (speed_upload);
+        info.size_download_bytes = static_cast<int64_t> (size_download);
+        info.size_upload_bytes = static_cast<int64_t> (size_upload);
+        info.header_size_bytes = header_size;
+        info.request_size_bytes = request_size;
+        info.ssl_verifyresult = ssl_verifyresult;
+        info.os_errno = os_errno;
+        info.num_connects = num_connects;
+        info.connection_reused = 0 == num_connects;
+        info.http_version = http_version;
+        info.primary_ip = std::string(primary_ip.data());
+        info.primary_port = primary_port;
+        return info;
+    }
+
+private:
+    static double micros_to_secs(curl_off_t micros) {
+        if (micros < 0) return -1;
+        return static_cast<double> (micros) / 1000000;
+    }
+
+    static curl_off_t secs_to_micros(double secs) {
+        if (secs < 0) return -1;
+        return static_cast<curl_off_t> (secs * 1000000);
+    }
+};
+
+inline curl_info_snapshot curl_collect_info(CURL* handle, const std::string& url) {
+    curl_info_snapshot snapshot;
+    snapshot.collect(handle, url);
+    return snapshot;
+}
 
 } // namespace
 }
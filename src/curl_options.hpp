@@ -25,8 +25,10 @@
 #define STATICLIB_HTTP_CURL_OPTIONS_HPP
 
 #include <cstdint>
+#include <cctype>
+#include <ios>
+#include <istream>
 #include <memory>
-#include <cstdint>
 
 #include "curl/curl.h"
 
@@ -37,6 +39,7 @@
 #include "staticlib/http/http_exception.hpp"
 
 #include "curl_headers.hpp"
+#include "request_body_reader.hpp"
 
 namespace staticlib {
 namespace http {
@@ -46,19 +49,28 @@ class curl_options {
     sl::support::observer_ptr<T> cb_obj;
     sl::support::observer_ptr<std::string> url;
     sl::support::observer_ptr<request_options> options;
-    sl::support::observer_ptr<std::istream> post_data;
+    // body is read either from post_data or pushed by the client
+    bool has_body;
+    // negative if unknown
+    int64_t post_data_size;
+    sl::support::observer_ptr<request_body_reader> body;
     sl::support::observer_ptr<curl_headers> headers;
     // CURL is void so cannot be used with observer
     CURL* handle;
+    bool send_chunked = false;
+    bool suppress_expect = false;
 
 public:
     curl_options(T* cb_obj, std::string& url, request_options& options,
-            std::unique_ptr<std::istream>& post_data, curl_headers& headers,
-            std::unique_ptr<CURL, curl_easy_deleter>& handle) :
+            std::unique_ptr<std::istream>& post_data, request_body_reader& body,
+            curl_headers& headers, std::unique_ptr<CURL, curl_easy_deleter>& handle,
+            bool pushed_body = false) :
     cb_obj(sl::support::make_observer_ptr(cb_obj)),
     url(sl::support::make_observer_ptr(url)),
     options(sl::support::make_observer_ptr(options)),
-    post_data(sl::support::make_observer_ptr(post_data.get())),
+    has_body(nullptr != post_data.get() || pushed_body),
+    post_data_size(detect_stream_size(post_data)),
+    body(sl::support::make_observer_ptr(body)),
     headers(sl::support::make_observer_ptr(headers)),
     handle(handle.get()) { }
 
@@ -74,7 +86,8 @@ public:
         appply_method();
 
         // headers
-        auto slist = headers->wrap_into_slist(this->options->headers);
+        auto slist = headers->wrap_into_slist(options->headers, options->dynamic_headers,
+                send_chunked, suppress_expect);
         if (slist.has_value()) {
             setopt_object(CURLOPT_HTTPHEADER, static_cast<void*> (slist.value()));
         }
@@ -110,6 +123,10 @@ public:
         setopt_uint32(CURLOPT_TCP_KEEPINTVL, options->tcp_keepintvl_secs);
         setopt_uint32(CURLOPT_CONNECTTIMEOUT_MS, options->connecttimeout_millis);
         setopt_uint32(CURLOPT_TIMEOUT_MS, options->timeout_millis);
+        // Added in 7.36.0
+#if LIBCURL_VERSION_NUM >= 0x072400
+        setopt_uint32(CURLOPT_EXPECT_100_TIMEOUT_MS, options->expect_100_timeout_millis);
+#endif // LIBCURL_VERSION_NUM
 
         // HTTP options
         setopt_uint32(CURLOPT_BUFFERSIZE, options->buffersize_bytes);
@@ -228,28 +245,106 @@ private:
         } else if ("POST" == options->method) {
             setopt_bool(CURLOPT_POST, true);
         } else if ("PUT" == options->method) {
+            // POSTFIELDS would add "Content-Type: application/x-www-form-urlencoded"
             setopt_bool(CURLOPT_PUT, true);
+        } else if ("HEAD" == options->method) {
+            setopt_bool(CURLOPT_NOBODY, true);
         } else if ("DELETE" == options->method) {
             setopt_string(CURLOPT_CUSTOMREQUEST, "DELETE");
         } else throw http_exception(TRACEMSG(
                 "Unsupported HTTP method: [" + options->method + "]"));
-        if (nullptr != post_data.get() && ("POST" == options->method || "PUT" == options->method)) {
-            setopt_object(CURLOPT_READDATA, cb_obj.get());
-            CURLcode err_wf = curl_easy_setopt(handle, CURLOPT_READFUNCTION, curl_options<T>::read_callback);
-            if (err_wf != CURLE_OK) throw http_exception(TRACEMSG(
-                    "Error setting option: [CURLOPT_READFUNCTION], error: [" + curl_easy_strerror(err_wf) + "]"));
+        if (!("POST" == options->method || "PUT" == options->method)) return;
+        if (body->get_body().is_present()) {
+            apply_sized_body();
+        } else if (has_body) {
+            apply_read_callback();
             if (options->send_request_body_content_length) {
-                CURLcode err = curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE, static_cast<long> (options->request_body_content_length));
-                if (err != CURLE_OK) throw http_exception(TRACEMSG(
-                        "Error setting option: [CURLOPT_POSTFIELDSIZE]," +
-                        " to value: [" + sl::support::to_string(options->request_body_content_length) + "]," +
-                        " error: [" + curl_easy_strerror(err) + "]"));
+                setopt_content_length(options->request_body_content_length);
+            } else if (post_data_size >= 0) {
+                setopt_content_length(static_cast<uint64_t> (post_data_size));
             } else {
-                options->headers.emplace_back("Transfer-Encoding", "chunked");
+                this->send_chunked = true;
             }
+        } else {
+            return;
+        }
+        this->suppress_expect = !options->send_expect_100_continue && !has_expect_header();
+    }
+
+    void apply_read_callback() {
+        setopt_object(CURLOPT_READDATA, cb_obj.get());
+        CURLcode err_wf = curl_easy_setopt(handle, CURLOPT_READFUNCTION, curl_options<T>::read_callback);
+        if (err_wf != CURLE_OK) throw http_exception(TRACEMSG(
+                "Error setting option: [CURLOPT_READFUNCTION], error: [" + curl_easy_strerror(err_wf) + "]"));
+    }
+
+    // Content-Length is sent by cURL for both variants,
+    // PUT bodies are always read with the callback
+    void apply_sized_body() {
+        auto& rb = body->get_body();
+        if (body->is_contiguous() && "PUT" != options->method) {
+            // not copied by cURL, must outlive the transfer
+            const char* data = rb.get_segments().empty() ? "" : rb.get_segments().front().data();
+            setopt_object(CURLOPT_POSTFIELDS, static_cast<void*> (const_cast<char*> (data)));
+            setopt_off_t(CURLOPT_POSTFIELDSIZE_LARGE, rb.size());
+        } else {
+            apply_read_callback();
+            setopt_content_length(rb.size());
+        }
+    }
+
+    // CURLOPT_PUT uploads are sized separately from POSTs
+    void setopt_content_length(uint64_t len) {
+        if ("PUT" == options->method) {
+            setopt_off_t(CURLOPT_INFILESIZE_LARGE, len);
+        } else {
+            setopt_off_t(CURLOPT_POSTFIELDSIZE_LARGE, len);
         }
     }
 
+    bool has_expect_header() {
+        for (auto& pa : options->headers) {
+            if (is_expect_name(pa.first)) return true;
+        }
+        for (auto& pa : options->dynamic_headers) {
+            if (is_expect_name(pa.first)) return true;
+        }
+        return false;
+    }
+
+    static bool is_expect_name(const std::string& name) {
+        static const std::string expect = "expect";
+        if (expect.length() != name.length()) return false;
+        for (size_t i = 0; i < name.length(); i++) {
+            if (expect[i] != std::tolower(static_cast<unsigned char> (name[i]))) return false;
+        }
+        return true;
+    }
+
+    // remaining size of string and file streams, pion
+    // and other unbuffered sources do not support seeking
+    static int64_t detect_stream_size(std::unique_ptr<std::istream>& post_data) {
+        if (nullptr == post_data.get() || nullptr == post_data->rdbuf()) return -1;
+        auto sbuf = post_data->rdbuf();
+        std::streamoff cur = sbuf->pubseekoff(0, std::ios_base::cur, std::ios_base::in);
+        if (cur < 0) return -1;
+        std::streamoff end = sbuf->pubseekoff(0, std::ios_base::end, std::ios_base::in);
+        sbuf->pubseekpos(cur, std::ios_base::in);
+        if (end < cur) return -1;
+        return static_cast<int64_t> (end - cur);
+    }
+
+    void setopt_off_t(CURLoption opt, uint64_t value) {
+        if (value > static_cast<uint64_t> (std::numeric_limits<int64_t>::max())) throw http_exception(TRACEMSG(
+                "Error setting option: [" + sl::support::to_string(opt) + "]," +
+                " to invalid overflow value: [" + sl::support::to_string(value) + "]"));
+        CURLcode err = curl_easy_setopt(handle, opt, static_cast<curl_off_t> (value));
+        if (err != CURLE_OK) throw http_exception(TRACEMSG(
+                "Error setting option: [" + sl::support::to_string(opt) + "]," +
+                " to value: [" + sl::support::to_string(value) + "]," +
+                " error: [" + curl_easy_strerror(err) + "]"));
+    }
+
 };
 
 class curl_multi_options {
@@ -288,9 +383,10 @@ private:
 
 template<typename T>
 void apply_curl_options(T* cb_obj, std::string& url, request_options& options,
-        std::unique_ptr<std::istream>& post_data, curl_headers& headers,
-        std::unique_ptr<CURL, curl_easy_deleter>& handle) {
-    curl_options<T>(cb_obj, url, options, post_data, headers, handle).apply();
+        std::unique_ptr<std::istream>& post_data, request_body_reader& body,
+        curl_headers& headers, std::unique_ptr<CURL, curl_easy_deleter>& handle,
+        bool pushed_body = false) {
+    curl_options<T>(cb_obj, url, options, post_data, body, headers, handle, pushed_body).apply();
 }
 
 inline void apply_curl_multi_options(CURLM* handle, session_options& options) {
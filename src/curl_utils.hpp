@@ -24,6 +24,7 @@
 #ifndef STATICLIB_HTTP_CURL_UTILS_HPP
 #define STATICLIB_HTTP_CURL_UTILS_HPP
 
+#include <cctype>
 #include <cstring>
 #include <string>
 #include <utility>
@@ -58,31 +59,52 @@ inline fd_set create_fd() {
     return res;
 }
 
+// header line length without "\r\n" ("\n" for LF-only servers)
+inline size_t curl_header_line_length(const char* buffer, size_t len) {
+    if (len > 0 && '\n' == buffer[len - 1]) {
+        len -= 1;
+    }
+    if (len > 0 && '\r' == buffer[len - 1]) {
+        len -= 1;
+    }
+    return len;
+}
+
+// empty line after the headers block
+inline bool curl_header_is_blank(const char* buffer, size_t len) {
+    return 0 == curl_header_line_length(buffer, len);
+}
+
 // http://stackoverflow.com/a/9681122/314015
 inline sl::support::optional<std::pair<std::string, std::string>> curl_parse_header(const char* buffer, size_t len) {
-    std::string name;
-    std::string value;
+    size_t end = curl_header_line_length(buffer, len);
     size_t i = 0;
-    // 2 for '\r\n'
-    for (; i < len - 2; i++) {
-        if (':' != buffer[i]) {
-            name.push_back(buffer[i]);
-        } else {
-            break;
-        }
+    while (i < end && ':' != buffer[i]) {
+        i += 1;
     }
-    if (':' == buffer[i]) {
-        // 2 for ': ', 2 for '\r\n'
-        size_t valen = len - i - 2 - 2;
-        if (valen > 0) {
-            value.resize(valen);
-            std::memcpy(std::addressof(value.front()), buffer + i + 2, value.length());
+    if (i < end) {
+        size_t vstart = i + 1;
+        while (vstart < end && ' ' == buffer[vstart]) {
+            vstart += 1;
+        }
+        if (vstart < end) {
+            auto name = std::string(buffer, i);
+            auto value = std::string(buffer + vstart, end - vstart);
             return sl::support::make_optional(std::make_pair(std::move(name), std::move(value)));
         }
     }
     return sl::support::optional<std::pair<std::string, std::string>>();
 }
 
+// header names are case-insensitive
+inline bool curl_header_name_equals(const std::string& name_lower, const std::string& name) {
+    if (name_lower.length() != name.length()) return false;
+    for (size_t i = 0; i < name.length(); i++) {
+        if (name_lower[i] != std::tolower(static_cast<unsigned char> (name[i]))) return false;
+    }
+    return true;
+}
+
 } // namespace
 }
 
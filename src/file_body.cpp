@@ -0,0 +1,164 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   file_body.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 10:10 PM
+ */
+
+#include "staticlib/http/file_body.hpp"
+
+#include <cstdint>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#ifdef STATICLIB_WINDOWS
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif // NOMINMAX
+#include <windows.h>
+#else // !STATICLIB_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // STATICLIB_WINDOWS
+
+#include "staticlib/config.hpp"
+#include "staticlib/support.hpp"
+
+namespace staticlib {
+namespace http {
+
+namespace { // anonymous
+
+// read-only mapping of the whole file, owned by request bodies
+class mapped_file {
+    const char* addr = nullptr;
+    size_t length = 0;
+#ifdef STATICLIB_WINDOWS
+    HANDLE mapping = NULL;
+#endif // STATICLIB_WINDOWS
+
+public:
+    mapped_file(const std::string& path) {
+#ifdef STATICLIB_WINDOWS
+        HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (INVALID_HANDLE_VALUE == file) throw http_exception(TRACEMSG(
+                "Error opening file, path: [" + path + "]," +
+                " error: [" + sl::support::to_string(::GetLastError()) + "]"));
+        LARGE_INTEGER size;
+        if (0 == ::GetFileSizeEx(file, std::addressof(size))) {
+            auto err = ::GetLastError();
+            ::CloseHandle(file);
+            throw http_exception(TRACEMSG("Error getting file size, path: [" + path + "]," +
+                    " error: [" + sl::support::to_string(err) + "]"));
+        }
+        this->length = checked_length(static_cast<uint64_t> (size.QuadPart), path);
+        if (length > 0) {
+            this->mapping = ::CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+            auto err = ::GetLastError();
+            ::CloseHandle(file);
+            if (NULL == mapping) throw http_exception(TRACEMSG(
+                    "Error mapping file, path: [" + path + "]," +
+                    " error: [" + sl::support::to_string(err) + "]"));
+            this->addr = static_cast<const char*> (::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            if (nullptr == addr) {
+                auto err_view = ::GetLastError();
+                ::CloseHandle(mapping);
+                throw http_exception(TRACEMSG("Error mapping file view, path: [" + path + "]," +
+                        " error: [" + sl::support::to_string(err_view) + "]"));
+            }
+        } else {
+            ::CloseHandle(file);
+        }
+#else // !STATICLIB_WINDOWS
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (-1 == fd) throw http_exception(TRACEMSG(
+                "Error opening file, path: [" + path + "]," +
+                " error: [" + ::strerror(errno) + "]"));
+        struct stat st;
+        if (-1 == ::fstat(fd, std::addressof(st)) || !S_ISREG(st.st_mode)) {
+            ::close(fd);
+            throw http_exception(TRACEMSG("Error accessing regular file, path: [" + path + "]"));
+        }
+        try {
+            this->length = checked_length(static_cast<uint64_t> (st.st_size), path);
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+        if (length > 0) {
+            void* res = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            auto err = errno;
+            // mapping stays valid after close
+            ::close(fd);
+            if (MAP_FAILED == res) throw http_exception(TRACEMSG(
+                    "Error mapping file, path: [" + path + "]," +
+                    " error: [" + ::strerror(err) + "]"));
+            // hint only, failure is not an error
+            ::madvise(res, length, MADV_SEQUENTIAL);
+            this->addr = static_cast<const char*> (res);
+        } else {
+            ::close(fd);
+        }
+#endif // STATICLIB_WINDOWS
+    }
+
+    mapped_file(const mapped_file&) = delete;
+
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    ~mapped_file() STATICLIB_NOEXCEPT {
+        if (nullptr == addr) return;
+#ifdef STATICLIB_WINDOWS
+        ::UnmapViewOfFile(addr);
+        ::CloseHandle(mapping);
+#else // !STATICLIB_WINDOWS
+        ::munmap(const_cast<char*> (addr), length);
+#endif // STATICLIB_WINDOWS
+    }
+
+    sl::io::span<const char> get_span() const {
+        return sl::io::span<const char>(addr, length);
+    }
+
+private:
+    static size_t checked_length(uint64_t size, const std::string& path) {
+        if (size > static_cast<uint64_t> (std::numeric_limits<size_t>::max())) throw http_exception(TRACEMSG(
+                "File is too large to be mapped on this platform, path: [" + path + "]," +
+                " size: [" + sl::support::to_string(size) + "]"));
+        return static_cast<size_t> (size);
+    }
+};
+
+} // namespace
+
+request_body map_file_body(const std::string& path) {
+    auto mf = std::make_shared<mapped_file>(path);
+    auto segments = std::vector<sl::io::span<const char>>();
+    segments.push_back(mf->get_span());
+    return request_body(std::move(segments), std::move(mf));
+}
+
+} // namespace
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   http_probes.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 5:10 PM
+ */
+
+#ifndef STATICLIB_HTTP_HTTP_PROBES_HPP
+#define STATICLIB_HTTP_HTTP_PROBES_HPP
+
+// USDT probes, provider name is 'staticlib_http',
+// first argument of every probe is the resource id:
+//
+// ticket_enqueue(id)
+// ticket_dequeue(id)
+// multi_add(id)
+// first_header(id, status_code)
+// write_data(id, bytes)
+// pause(id)
+// unpause(id)
+// complete(id, curl_code)
+// consumer_read(id, bytes)
+// resume(id, attempt)
+//
+// when enabled every probe is a single nop until attached,
+// when disabled arguments are not evaluated
+
+#ifdef STATICLIB_HTTP_ENABLE_USDT
+
+#include <sys/sdt.h>
+
+#define STATICLIB_HTTP_PROBE1(name, arg1) \
+        DTRACE_PROBE1(staticlib_http, name, arg1)
+#define STATICLIB_HTTP_PROBE2(name, arg1, arg2) \
+        DTRACE_PROBE2(staticlib_http, name, arg1, arg2)
+
+#else // !STATICLIB_HTTP_ENABLE_USDT
+
+#define STATICLIB_HTTP_PROBE1(name, arg1) ((void) 0)
+#define STATICLIB_HTTP_PROBE2(name, arg1, arg2) ((void) 0)
+
+#endif // STATICLIB_HTTP_ENABLE_USDT
+
+#endif /* STATICLIB_HTTP_HTTP_PROBES_HPP */
+
@@ -0,0 +1,258 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   metrics_collector.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 4:22 PM
+ */
+
+#ifndef STATICLIB_HTTP_METRICS_COLLECTOR_HPP
+#define STATICLIB_HTTP_METRICS_COLLECTOR_HPP
+
+#include <cstdint>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <thread>
+
+#include "curl/curl.h"
+
+#include "staticlib/config.hpp"
+
+#include "staticlib/http/session_metrics.hpp"
+
+#include "curl_info.hpp"
+
+namespace staticlib {
+namespace http {
+
+// counter that is incremented from multiple threads,
+// every thread writes mostly into its own cache line
+class sharded_counter {
+    struct shard {
+        std::atomic<uint64_t> value;
+        char padding[64 - sizeof(std::atomic<uint64_t>)];
+
+        shard() :
+        value(0) { }
+    };
+
+    std::array<shard, 8> shards;
+
+public:
+    void add(uint64_t delta) {
+        size_t idx = std::hash<std::thread::id>()(std::this_thread::get_id()) % shards.size();
+        shards[idx].value.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    // shard values wrap around, their sum stays exact
+    void sub(uint64_t delta) {
+        size_t idx = std::hash<std::thread::id>()(std::this_thread::get_id()) % shards.size();
+        shards[idx].value.fetch_sub(delta, std::memory_order_relaxed);
+    }
+
+    uint64_t get() const {
+        uint64_t res = 0;
+        for (auto& sh : shards) {
+            res += sh.value.load(std::memory_order_relaxed);
+        }
+        return res;
+    }
+};
+
+// values below 4 are exact, every following power of two
+// range is split into 4 linear sub-buckets
+class atomic_histogram {
+    static const size_t sub_buckets = 4;
+    static const size_t max_exponent = 40;
+    static const size_t buckets_count = sub_buckets + (max_exponent - 1) * sub_buckets;
+
+    std::array<std::atomic<uint64_t>, buckets_count> counts;
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sum;
+
+public:
+    atomic_histogram() :
+    count(0),
+    sum(0) {
+        for (auto& en : counts) {
+            en.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void record(int64_t value) {
+        if (value < 0) return;
+        uint64_t val = static_cast<uint64_t> (value);
+        counts[bucket_index(val)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(val, std::memory_order_relaxed);
+    }
+
+    latency_histogram snapshot() const {
+        latency_histogram res;
+        res.bounds_micros.reserve(counts.size());
+        res.counts.reserve(counts.size());
+        for (size_t i = 0; i < counts.size(); i++) {
+            res.bounds_micros.push_back(bucket_upper_bound(i));
+            res.counts.push_back(counts[i].load(std::memory_order_relaxed));
+        }
+        res.count = count.load(std::memory_order_relaxed);
+        res.sum_micros = sum.load(std::memory_order_relaxed);
+        return res;
+    }
+
+    static size_t bucket_index(uint64_t val) {
+        if (val < sub_buckets) {
+            return static_cast<size_t> (val);
+        }
+        size_t exp = 0;
+        for (uint64_t v = val; v > 1; v >>= 1) {
+            exp += 1;
+        }
+        if (exp > max_exponent) {
+            return buckets_count - 1;
+        }
+        size_t sub = static_cast<size_t> ((val >> (exp - 2)) & (sub_buckets - 1));
+        return sub_buckets + (exp - 2) * sub_buckets + sub;
+    }
+
+    static uint64_t bucket_upper_bound(size_t idx) {
+        if (idx < sub_buckets) {
+            return static_cast<uint64_t> (idx);
+        }
+        size_t exp = (idx - sub_buckets) / sub_buckets + 2;
+        size_t sub = (idx - sub_buckets) % sub_buckets;
+        return (static_cast<uint64_t> (sub_buckets + sub + 1) << (exp - 2)) - 1;
+    }
+};
+
+// all updates are relaxed atomics, snapshot is not
+// consistent across counters, that is fine for monitoring
+class metrics_collector {
+    sharded_counter submitted;
+    sharded_counter completed;
+    sharded_counter failed;
+    sharded_counter bytes_received;
+    sharded_counter bytes_sent;
+    sharded_counter new_connections;
+    std::atomic<int64_t> in_flight;
+    std::atomic<int64_t> queued;
+    std::atomic<int64_t> paused;
+    std::array<std::atomic<uint64_t>, CURL_LAST + 1> errors;
+    atomic_histogram total_time;
+    atomic_histogram ttfb;
+    atomic_histogram queue_time;
+
+public:
+    metrics_collector() :
+    in_flight(0),
+    queued(0),
+    paused(0) {
+        for (auto& en : errors) {
+            en.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    metrics_collector(const metrics_collector&) = delete;
+
+    metrics_collector& operator=(const metrics_collector&) = delete;
+
+    void on_submitted(bool enqueued) {
+        submitted.add(1);
+        in_flight.fetch_add(1, std::memory_order_relaxed);
+        if (enqueued) {
+            queued.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // reverts "on_submitted" when the request was not accepted
+    void on_submit_rejected(bool enqueued) {
+        submitted.sub(1);
+        in_flight.fetch_sub(1, std::memory_order_relaxed);
+        if (enqueued) {
+            queued.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    void on_dequeued() {
+        queued.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void on_paused_count(size_t count) {
+        paused.store(static_cast<int64_t> (count), std::memory_order_relaxed);
+    }
+
+    // info may be empty if collection failed
+    void on_finished(const curl_info_snapshot& info, CURLcode code, bool aborted) {
+        in_flight.fetch_sub(1, std::memory_order_relaxed);
+        if (!aborted && CURLE_OK == code) {
+            completed.add(1);
+        } else {
+            failed.add(1);
+            if (!aborted && code > 0 && code <= CURL_LAST) {
+                errors[static_cast<size_t> (code)].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        if (!info.is_collected()) {
+            return;
+        }
+        if (info.get_size_download_bytes() > 0) {
+            bytes_received.add(static_cast<uint64_t> (info.get_size_download_bytes()));
+        }
+        if (info.get_size_upload_bytes() > 0) {
+            bytes_sent.add(static_cast<uint64_t> (info.get_size_upload_bytes()));
+        }
+        if (info.get_num_connects() > 0) {
+            new_connections.add(static_cast<uint64_t> (info.get_num_connects()));
+        }
+        total_time.record(info.get_total_time_micros());
+        if (info.get_starttransfer_time_micros() > 0) {
+            ttfb.record(info.get_starttransfer_time_micros());
+        }
+        queue_time.record(info.get_queue_time_micros());
+    }
+
+    session_metrics snapshot() const {
+        session_metrics res;
+        res.requests_submitted = submitted.get();
+        res.requests_completed = completed.get();
+        res.requests_failed = failed.get();
+        res.requests_in_flight = in_flight.load(std::memory_order_relaxed);
+        res.requests_queued = queued.load(std::memory_order_relaxed);
+        res.transfers_paused = paused.load(std::memory_order_relaxed);
+        res.bytes_received = bytes_received.get();
+        res.bytes_sent = bytes_sent.get();
+        res.new_connections = new_connections.get();
+        for (size_t i = 0; i < errors.size(); i++) {
+            uint64_t count = errors[i].load(std::memory_order_relaxed);
+            if (count > 0) {
+                res.errors_by_curl_code.emplace_back(static_cast<int> (i), count);
+            }
+        }
+        res.total_time = total_time.snapshot();
+        res.ttfb = ttfb.snapshot();
+        res.queue_time = queue_time.snapshot();
+        return res;
+    }
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_HTTP_METRICS_COLLECTOR_HPP */
+
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * File:   mpsc_queue.hpp
+ * Author: alex
+ *
+ * Created on October 19, 2026, 10:05 AM
+ */
+
+#ifndef STATICLIB_HTTP_MPSC_QUEUE_HPP
+#define STATICLIB_HTTP_MPSC_QUEUE_HPP
+
+#include <cstddef>
+#include <atomic>
+#include <utility>
+
+#include "staticlib/config.hpp"
+
+namespace staticlib {
+namespace http {
+
+// lock-free multiple producers single consumer queue,
+// producers push onto the intrusive stack, consumer takes
+// the whole stack at once (so there is no ABA problem)
+// and processes it in the push order
+template<typename T>
+class mpsc_queue {
+    struct node {
+        T value;
+        node* next;
+
+        node(T&& value) :
+        value(std::move(value)),
+        next(nullptr) { }
+    };
+
+    std::atomic<node*> head;
+
+public:
+    mpsc_queue() :
+    head(nullptr) { }
+
+    mpsc_queue(const mpsc_queue&) = delete;
+
+    mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+    ~mpsc_queue() STATICLIB_NOEXCEPT {
+        delete_list(head.exchange(nullptr, std::memory_order_acquire));
+    }
+
+    // any thread
+    void push(T value) {
+        auto nd = new node(std::move(value));
+        nd->next = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(nd->next, nd,
+                std::memory_order_release, std::memory_order_relaxed)) { }
+    }
+
+    // consumer thread only, elements not yet passed
+    // to the callback are dropped if it throws
+    template<typename Func>
+    size_t drain(Func fun) {
+        node* top = head.exchange(nullptr, std::memory_order_acquire);
+        // reverse into push order
+        node* list = nullptr;
+        while (nullptr != top) {
+            node* next = top->next;
+            top->next = list;
+            list = top;
+            top = next;
+        }
+        size_t count = 0;
+        while (nullptr != list) {
+            node* nd = list;
+            list = nd->next;
+            try {
+                fun(std::move(nd->value));
+            } catch (...) {
+                delete nd;
+                delete_list(list);
+                throw;
+            }
+            delete nd;
+            count += 1;
+        }
+        return count;
+    }
+
+private:
+    static void delete_list(node* list) STATICLIB_NOEXCEPT {
+        while (nullptr != list) {
+            node* next = list->next;
+            delete list;
+            list = next;
+        }
+    }
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_HTTP_MPSC_QUEUE_HPP */
+
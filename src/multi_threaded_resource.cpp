@@ -23,6 +23,7 @@
 
 #include "multi_threaded_resource.hpp"
 
+#include <cctype>
 #include <cstring>
 #include <chrono>
 #include <ios>
@@ -39,6 +40,9 @@
 #include "staticlib/http/resource_info.hpp"
 #include "staticlib/http/http_exception.hpp"
 
+#include "http_probes.hpp"
+#include "request_resubmitter.hpp"
+#include "request_timeline.hpp"
 #include "resource_impl.hpp"
 #include "resource_params.hpp"
 
@@ -49,6 +53,23 @@ namespace { // anonymous
 
 using headers_type = const std::vector<std::pair<std::string, std::string>>&;
 
+bool equals_ignore_case(const std::string& expected_lower, const std::string& value) {
+    if (expected_lower.length() != value.length()) return false;
+    for (size_t i = 0; i < value.length(); i++) {
+        if (expected_lower[i] != std::tolower(static_cast<unsigned char> (value[i]))) return false;
+    }
+    return true;
+}
+
+std::string find_header(const running_request_pipe::headers_type& headers, const std::string& name_lower) {
+    for (auto& en : headers) {
+        if (equals_ignore_case(name_lower, en.first)) {
+            return en.second;
+        }
+    }
+    return "";
+}
+
 } // namespace
 
 
@@ -58,12 +79,22 @@ class multi_threaded_resource::impl : public resource::impl {
     std::string url;
 
     mutable std::shared_ptr<running_request_pipe> pipe;
-    mutable std::vector<std::pair<std::string, std::string>> headers;
+    // first request, keeps status code and headers after resume
+    std::shared_ptr<running_request_pipe> origin_pipe;
+    std::shared_ptr<request_resubmitter> resubmitter;
+    std::string resume_validator;
+    uint64_t received_bytes = 0;
+    uint16_t resume_attempts = 0;
+    mutable std::shared_ptr<const running_request_pipe::headers_type> headers;
+    // keeps references, returned from 'get_headers', valid
+    mutable std::vector<std::shared_ptr<const running_request_pipe::headers_type>> headers_prev;
+    mutable bool headers_complete = false;
 
     sl::concurrent::growing_buffer current_buf;
     size_t start_idx = 0;
     bool empty_response = false;
     mutable std::string pipe_error;
+    request_timeline consumer_timeline;
 
 public:
     impl(uint64_t resource_id, const request_options& req_options, resource_params&& params):
@@ -71,11 +102,23 @@ public:
     id(resource_id),
     request_opts(req_options),
     url(params.url.data(), params.url.length()),
-    pipe(std::move(params.pipe)) {
+    pipe(std::move(params.pipe)),
+    resubmitter(std::move(params.resubmitter)),
+    headers(pipe->get_headers()),
+    consumer_timeline(request_opts.record_timeline) {
         // read first data chunk to make sure that status_code is ready
         this->empty_response = !pipe->receive_some_data(current_buf);
+        if (!empty_response) {
+            received_bytes += current_buf.size();
+        }
+        init_resume_validator();
         if (pipe->has_errors()) {
-            throw http_exception(TRACEMSG(pipe->get_error_message()));
+            if (!resume_validator.empty() && (!empty_response || can_resume())) {
+                // errors are checked again, when received data is consumed
+                this->empty_response = false;
+            } else {
+                throw http_exception(TRACEMSG(pipe->get_error_message()));
+            }
         }
     }
 
@@ -84,17 +127,34 @@ public:
         if (avail > 0) {
             return read_from_current(span, avail);
         } else if (empty_response) {
+            consumer_timeline.mark_consumer_eof();
             return std::char_traits<char>::eof();
         }
         start_idx = 0;
-        bool success = pipe->receive_some_data(current_buf);
-        if (pipe->has_errors()) {
-            throw http_exception(TRACEMSG(pipe->get_error_message()));
-        }
-        if (success) {
-            return read_from_current(span, current_buf.size());
-        } else {
-            return std::char_traits<char>::eof();
+        for (;;) {
+            bool success = pipe->receive_some_data(current_buf);
+            if (success && 0 == current_buf.size()) {
+                // status notification, body is written to file by worker
+                continue;
+            }
+            if (success && !resume_validator.empty()) {
+                // errors are deferred until all received data is consumed
+                received_bytes += current_buf.size();
+                return read_from_current(span, current_buf.size());
+            }
+            if (pipe->has_errors() && !can_resume()) {
+                throw http_exception(TRACEMSG(pipe->get_error_message()));
+            }
+            if (success) {
+                return read_from_current(span, current_buf.size());
+            }
+            if (!can_resume()) {
+                consumer_timeline.mark_consumer_eof();
+                return std::char_traits<char>::eof();
+            }
+            if (resume()) {
+                return read_from_current(span, current_buf.size());
+            }
         }
     }
 
@@ -103,34 +163,41 @@ public:
     }
 
     virtual uint16_t get_status_code(const resource&) const override {
-        return pipe->get_response_code();
+        return headers_pipe().get_response_code();
     }
 
     virtual resource_info get_info(const resource&) const override {
-        return pipe->get_resource_info();
+        return pipe->get_resource_info(url);
+    }
+
+    virtual resource_timeline get_timeline(const resource&) const override {
+        auto res = pipe->get_timeline();
+        res.consumer_eof = consumer_timeline.get().consumer_eof;
+        return res;
     }
 
     virtual const std::vector<std::pair<std::string, std::string>>& get_headers(const resource&) const override {
         load_more_headers();
-        return headers;
+        return *headers;
     }
 
     virtual const std::string& get_header(const resource&, const std::string& name) const override {
         // try cached first
-        for (auto& en : headers) {
+        for (auto& en : *headers) {
             if (name == en.first) {
                 return en.second;
             }
         }
         // load more if available
-        load_more_headers();
-        for (auto& en : headers) {
+        if (!load_more_headers()) {
+            return sl::utils::empty_string();
+        }
+        for (auto& en : *headers) {
             if (name == en.first) {
                 return en.second;
             }
         }
-        static std::string empty;
-        return empty;
+        return sl::utils::empty_string();
     }
 
     virtual bool connection_successful(const resource& frontend) const override {
@@ -158,14 +225,103 @@ private:
         size_t len = avail <= span.size() ? avail : span.size();
         std::memcpy(span.data(), current_buf.data() + start_idx, len);
         start_idx += len;
+        STATICLIB_HTTP_PROBE2(consumer_read, id, len);
         return static_cast<std::streamsize> (len);
     }
 
-    void load_more_headers() const {
-        auto received = pipe->consume_received_headers();
-        for (auto&& he : received) {
-            headers.emplace_back(std::move(he));
+    running_request_pipe& headers_pipe() const {
+        return nullptr != origin_pipe.get() ? *origin_pipe : *pipe;
+    }
+
+    // only complete "200" responses to "GET" requests
+    // with a strong validator can be resumed
+    void init_resume_validator() {
+        if (0 == request_opts.resume_max_attempts || nullptr == resubmitter.get() ||
+                !request_opts.multi_threaded_response_body_file_path.empty() ||
+                "GET" != request_opts.method || 200 != pipe->get_response_code()) {
+            return;
+        }
+        auto hdrs = pipe->get_headers();
+        auto etag = find_header(*hdrs, "etag");
+        if (!etag.empty() && 0 != etag.find("W/")) {
+            this->resume_validator = etag;
+        } else {
+            this->resume_validator = find_header(*hdrs, "last-modified");
+        }
+    }
+
+    bool can_resume() {
+        return !resume_validator.empty() &&
+                resume_attempts < request_opts.resume_max_attempts &&
+                !pipe->is_running() &&
+                pipe->is_transfer_failed() &&
+                resubmitter->is_attached();
+    }
+
+    // returns true if first chunk of resumed response is received
+    bool resume() {
+        // drop errors of the failed attempt
+        pipe->get_error_message();
+        if (nullptr == origin_pipe.get()) {
+            // original headers are final at this point
+            load_more_headers();
+            this->headers_complete = true;
+            this->origin_pipe = pipe;
+        }
+        this->resume_attempts += 1;
+        auto opts = request_opts;
+        opts.dynamic_headers.emplace_back("Range", "bytes=" + sl::support::to_string(received_bytes) + "-");
+        opts.dynamic_headers.emplace_back("If-Range", resume_validator);
+        // status code and headers are checked on resumed responses
+        opts.abort_on_response_error = false;
+        STATICLIB_HTTP_PROBE2(resume, id, resume_attempts);
+        this->pipe = resubmitter->resubmit(id, url, std::move(opts));
+        // wait for the first chunk, so status code and headers are ready,
+        // chunk is consumed with the next 'receive_some_data' call
+        bool got_data = pipe->receive_some_data(current_buf);
+        uint16_t code = pipe->get_response_code();
+        if (0 == code) {
+            if (can_resume()) {
+                // failed to connect, try again
+                return false;
+            }
+            throw http_exception(TRACEMSG(pipe->get_error_message()));
+        }
+        if (206 != code) {
+            auto msg = 200 == code ?
+                    "Response representation changed between attempts" :
+                    "Invalid response status code on resume, code: [" + sl::support::to_string(code) + "]";
+            throw http_exception(TRACEMSG(msg + ", url: [" + url + "]," +
+                    " received bytes: [" + sl::support::to_string(received_bytes) + "]"));
+        }
+        auto range = find_header(*pipe->get_headers(), "content-range");
+        auto expected = "bytes " + sl::support::to_string(received_bytes) + "-";
+        if (0 != range.find(expected)) throw http_exception(TRACEMSG(
+                "Invalid 'Content-Range' on resume, expected: [" + expected + "...]," +
+                " actual: [" + range + "], url: [" + url + "]"));
+        if (got_data) {
+            received_bytes += current_buf.size();
+        }
+        return got_data;
+    }
+
+    bool load_more_headers() const {
+        if (headers_complete) {
+            return false;
+        }
+        // must be checked before loading, so the
+        // block published before shutdown is not missed
+        auto& hpipe = headers_pipe();
+        bool running = hpipe.is_running();
+        auto published = hpipe.get_headers();
+        this->headers_complete = !running;
+        if (published.get() == headers.get()) {
+            return false;
         }
+        // even an empty snapshot may be referenced by the caller
+        headers_prev.emplace_back(std::move(headers));
+        this->headers = std::move(published);
+        return true;
     }
 };
 PIMPL_FORWARD_CONSTRUCTOR(multi_threaded_resource, (uint64_t)(const request_options&)(resource_params&&), (), http_exception)
@@ -173,6 +329,7 @@ PIMPL_FORWARD_METHOD(multi_threaded_resource, std::streamsize, read, (sl::io::sp
 PIMPL_FORWARD_METHOD(multi_threaded_resource, const std::string&, get_url, (), (const), http_exception)
 PIMPL_FORWARD_METHOD(multi_threaded_resource, uint16_t, get_status_code, (), (const), http_exception)
 PIMPL_FORWARD_METHOD(multi_threaded_resource, resource_info, get_info, (), (const), http_exception)
+PIMPL_FORWARD_METHOD(multi_threaded_resource, resource_timeline, get_timeline, (), (const), http_exception)
 PIMPL_FORWARD_METHOD(multi_threaded_resource, headers_type, get_headers, (), (const), http_exception)
 PIMPL_FORWARD_METHOD(multi_threaded_resource, const std::string&, get_header, (const std::string&), (const), http_exception)
 PIMPL_FORWARD_METHOD(multi_threaded_resource, bool, connection_successful, (), (const), http_exception)
@@ -51,6 +51,8 @@ public:
 
     virtual resource_info get_info() const override;
 
+    virtual resource_timeline get_timeline() const override;
+
     virtual const std::vector<std::pair<std::string, std::string>>& get_headers() const override;
 
     virtual const std::string& get_header(const std::string& name) const override;
@@ -39,10 +39,13 @@
 #include "session_impl.hpp"
 #include "curl_headers.hpp"
 #include "curl_utils.hpp"
+#include "http_probes.hpp"
+#include "request_resubmitter.hpp"
 #include "resource_params.hpp"
 #include "multi_threaded_resource.hpp"
 #include "running_request_pipe.hpp"
 #include "running_request.hpp"
+#include "upload_pipe.hpp"
 
 namespace staticlib {
 namespace http {
@@ -53,6 +56,7 @@ class multi_threaded_session::impl : public session::impl {
     std::map<int64_t, std::unique_ptr<running_request>> requests;
 
     std::shared_ptr<sl::concurrent::condition_latch> pause_latch;
+    std::shared_ptr<request_resubmitter> resubmitter;
 
     std::thread worker;
     std::atomic<bool> running;
@@ -65,6 +69,10 @@ public:
     pause_latch(std::make_shared<sl::concurrent::condition_latch>([this] {
         return this->check_pause_condition();
     })),
+    resubmitter(std::make_shared<request_resubmitter>([this](uint64_t id, const std::string& url,
+            request_options opts) {
+        return this->resubmit_ticket(id, url, std::move(opts));
+    })),
     running(true) {
         worker = std::thread([this] {
             this->worker_proc();
@@ -72,6 +80,7 @@ public:
     }
 
     ~impl() STATICLIB_NOEXCEPT {
+        resubmitter->detach();
         running.store(false, std::memory_order_release);
         pause_latch->notify_one();
         tickets.unblock();
@@ -80,25 +89,78 @@ public:
 
     resource open_url(multi_threaded_session&, const std::string& url,
             std::unique_ptr<std::istream> post_data, request_options opts) {
+        return enqueue_ticket(url, std::move(post_data), request_body(), std::shared_ptr<upload_pipe>(),
+                std::move(opts));
+    }
+
+    resource open_url(multi_threaded_session&, const std::string& url,
+            request_body body, request_options opts) {
+        return enqueue_ticket(url, std::unique_ptr<std::istream>(), std::move(body), std::shared_ptr<upload_pipe>(),
+                std::move(opts));
+    }
+
+    resource open_url(multi_threaded_session&, const std::string& url,
+            upload_stream& post_data, request_options opts) {
+        auto upload = get_upload_pipe(post_data);
+        upload->attach_consumer(pause_latch);
+        return enqueue_ticket(url, std::unique_ptr<std::istream>(), request_body(), std::move(upload),
+                std::move(opts));
+    }
+
+    // not exposed
+
+    resource enqueue_ticket(const std::string& url, std::unique_ptr<std::istream> post_data,
+            request_body body, std::shared_ptr<upload_pipe> upload, request_options opts) {
         if ("" == opts.method) {
             opts.method = "POST";
         }
+        if (opts.resume_max_attempts > 0 && "GET" == opts.method) {
+            // "Range" offsets are counted in received bytes, they must not be decoded
+            opts.accept_encoding = "";
+        }
+        auto id = increment_resource_id();
+        auto pipe = enqueue_pipe(id, url, opts, std::move(post_data), std::move(body), std::move(upload));
+        auto params = resource_params(url, std::move(pipe), resubmitter);
+        return multi_threaded_resource(id, opts, std::move(params));
+    }
+
+    // called by resumable resources from consumer threads
+    std::shared_ptr<running_request_pipe> resubmit_ticket(uint64_t id, const std::string& url,
+            request_options opts) {
+        return enqueue_pipe(id, url, opts, std::unique_ptr<std::istream>(), request_body(),
+                std::shared_ptr<upload_pipe>());
+    }
+
+    std::shared_ptr<running_request_pipe> enqueue_pipe(uint64_t id, const std::string& url,
+            request_options& opts, std::unique_ptr<std::istream> post_data, request_body body,
+            std::shared_ptr<upload_pipe> upload) {
         //  note: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=63736
         auto pipe = std::make_shared<running_request_pipe>(opts, pause_latch);
-        auto enqueued = tickets.emplace(url, opts, std::move(post_data), pipe);
-        if (!enqueued) throw http_exception(TRACEMSG(
-                "Requests queue is full, size: [" + sl::support::to_string(tickets.size()) + "]"));
+        // must be counted before the worker can dequeue the ticket
+        metrics.on_submitted(true);
+        bool enqueued = false;
+        try {
+            enqueued = tickets.emplace(id, url, opts, std::move(post_data), std::move(body),
+                    std::move(upload), pipe);
+        } catch (...) {
+            metrics.on_submit_rejected(true);
+            throw;
+        }
+        if (!enqueued) {
+            metrics.on_submit_rejected(true);
+            throw http_exception(TRACEMSG(
+                    "Requests queue is full, size: [" + sl::support::to_string(tickets.size()) + "]"));
+        }
+        STATICLIB_HTTP_PROBE1(ticket_enqueue, id);
         new_tickets_arrived.exchange(true, std::memory_order_acq_rel);
         pause_latch->notify_one();
-        auto params = resource_params(url, std::move(pipe));
-        return multi_threaded_resource(increment_resource_id(), opts, std::move(params));
+        return pipe;
     }
 
-    // not exposed
-
     bool check_pause_condition() {
         // unpause when possible
         size_t num_paused = unpause_enqueued_requests();
+        metrics.on_paused_count(num_paused);
 
         // check more tickets
         if (new_tickets_arrived.load(std::memory_order_acquire)) {
@@ -212,6 +274,7 @@ private:
             running_request& req = *it->second;
             if (CURLMSG_DONE == cm->msg) {
                 CURLcode result = cm->data.result;
+                req.set_result(result);
                 if (req.get_options().abort_on_connect_error && CURLE_OK != result) {
                     req.append_error(curl_easy_strerror(result));
                 }
@@ -225,12 +288,8 @@ private:
         size_t num_paused = 0;
         for (auto& pa : requests) {
             running_request& req = *pa.second;
-            if (req.is_paused()) {
-                if (!req.data_queue_is_full()) {
-                    req.unpause();
-                } else {
-                    num_paused += 1;
-                }
+            if (req.is_paused() && req.unpause_if_ready()) {
+                num_paused += 1;
             }
         }
         return num_paused;
@@ -239,8 +298,12 @@ private:
     void enqueue_request(request_ticket&& ticket) {
         // local copy
         auto pipe = ticket.pipe;
+        ticket.timeline.mark_dequeued();
+        metrics.on_dequeued();
+        STATICLIB_HTTP_PROBE1(ticket_dequeue, ticket.id);
         try {
-            auto req = std::unique_ptr<running_request>(new running_request(handle.get(), std::move(ticket)));
+            auto req = std::unique_ptr<running_request>(new running_request(handle.get(), headers_cache,
+                    metrics, std::move(ticket)));
             auto ha = req->easy_handle();
             auto pa = std::make_pair(reinterpret_cast<int64_t> (ha), std::move(req));
             requests.insert(std::move(pa));
@@ -248,6 +311,7 @@ private:
             // these two lines are normally called
             // on requests queue pop, but here
             // enqueue itself failed
+            metrics.on_finished(curl_info_snapshot(), CURLE_OK, true);
             pipe->append_error(TRACEMSG(e.what()));
             pipe->shutdown();
         }
@@ -270,6 +334,8 @@ private:
 };
 PIMPL_FORWARD_CONSTRUCTOR(multi_threaded_session, (session_options), (), http_exception)
 PIMPL_FORWARD_METHOD(multi_threaded_session, resource, open_url, (const std::string&)(std::unique_ptr<std::istream>)(request_options), (), http_exception)
+PIMPL_FORWARD_METHOD(multi_threaded_session, resource, open_url, (const std::string&)(request_body)(request_options), (), http_exception)
+PIMPL_FORWARD_METHOD(multi_threaded_session, resource, open_url, (const std::string&)(upload_stream&)(request_options), (), http_exception)
 
 } // namespace
 }
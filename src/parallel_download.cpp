@@ -0,0 +1,218 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   parallel_download.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 11:55 PM
+ */
+
+#include "staticlib/http/parallel_download.hpp"
+
+#include <cctype>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <iterator>
+#include <stdexcept>
+
+#include "staticlib/support.hpp"
+#include "staticlib/pimpl/forward_macros.hpp"
+
+#include "parallel_job_driver.hpp"
+#include "positional_file_sink.hpp"
+
+namespace staticlib {
+namespace http {
+
+namespace { // anonymous
+
+using progress_type = std::function<void(const download_segment_result&)>;
+
+bool equals_ignore_case(const std::string& expected_lower, const std::string& value) {
+    if (expected_lower.length() != value.length()) return false;
+    for (size_t i = 0; i < value.length(); i++) {
+        if (expected_lower[i] != std::tolower(static_cast<unsigned char> (value[i]))) return false;
+    }
+    return true;
+}
+
+std::string find_header(const std::vector<std::pair<std::string, std::string>>& headers,
+        const std::string& name_lower) {
+    for (auto& pa : headers) {
+        if (equals_ignore_case(name_lower, pa.first)) {
+            return pa.second;
+        }
+    }
+    return "";
+}
+
+} // namespace
+
+class parallel_download::impl : public sl::pimpl::object::impl {
+    sl::support::observer_ptr<polling_session> session;
+    std::string url;
+    std::string file_path;
+    uint64_t segment_size;
+    request_options options;
+    progress_type progress;
+    parallel_job_driver driver;
+    bool ranged = false;
+
+public:
+    impl(polling_session& session, const std::string& url, const std::string& file_path,
+            uint64_t segment_size, uint32_t max_concurrency, request_options options,
+            uint32_t max_attempts, progress_type progress) :
+    session(sl::support::make_observer_ptr(session)),
+    url(url.data(), url.length()),
+    file_path(file_path.data(), file_path.length()),
+    segment_size(segment_size),
+    options(std::move(options)),
+    progress(std::move(progress)),
+    driver(session, "parallel download", max_concurrency, max_attempts) {
+        if (this->file_path.empty()) throw http_exception(TRACEMSG(
+                "Invalid empty 'file_path' specified for parallel download"));
+        if (0 == segment_size) throw http_exception(TRACEMSG(
+                "Invalid zero 'segment_size' specified for parallel download"));
+    }
+
+    std::vector<download_segment_result> run(parallel_download&) {
+        driver.check_idle();
+        auto results = create_segments(probe_size());
+        driver.run(static_cast<uint32_t> (results.size()), [this, &results](uint32_t idx) {
+            return this->submit(results[idx].segment);
+        }, [this, &results](uint32_t idx, resource& res) {
+            auto& sr = results[idx];
+            this->record_attempt(sr, res);
+            if (this->progress) {
+                this->progress(sr);
+            }
+            return sr.success;
+        });
+        return results;
+    }
+
+private:
+    // returns file size if ranges are supported, -1 otherwise
+    int64_t probe_size() {
+        auto opts = options;
+        opts.method = "HEAD";
+        // size of the identity representation
+        opts.accept_encoding = "";
+        opts.polling_response_body_file_path = "";
+        opts.polling_response_body_file_offset = -1;
+        session->open_url(url, opts);
+        auto probed = std::vector<resource>();
+        while (0 != session->enqueued_requests_count()) {
+            auto finished = session->poll();
+            std::move(finished.begin(), finished.end(), std::back_inserter(probed));
+        }
+        if (1 != probed.size()) throw http_exception(TRACEMSG(
+                "Parallel download error: unexpected requests finished in session," +
+                " count: [" + sl::support::to_string(probed.size()) + "]"));
+        auto& res = probed.front();
+        this->ranged = false;
+        if (!res.connection_successful() || 200 != res.get_status_code()) {
+            return -1;
+        }
+        auto headers = res.get_headers();
+        auto accept = find_header(headers, "accept-ranges");
+        auto length = find_header(headers, "content-length");
+        if (!equals_ignore_case("bytes", accept) || length.empty() ||
+                std::string::npos != length.find_first_not_of("0123456789")) {
+            return -1;
+        }
+        try {
+            auto size = std::stoll(length);
+            this->ranged = true;
+            return static_cast<int64_t> (size);
+        } catch (const std::out_of_range&) {
+            return -1;
+        }
+    }
+
+    std::vector<download_segment_result> create_segments(int64_t size) {
+        auto results = std::vector<download_segment_result>();
+        if (!ranged) {
+            results.resize(1);
+            results.front().segment.length = size >= 0 ? static_cast<uint64_t> (size) : 0;
+            return results;
+        }
+        uint64_t total = static_cast<uint64_t> (size);
+        uint64_t count = total > 0 ? (total + segment_size - 1) / segment_size : 1;
+        if (count > std::numeric_limits<uint32_t>::max()) throw http_exception(TRACEMSG(
+                "Parallel download segments count exceeded, file size: [" + sl::support::to_string(total) + "]," +
+                " segment size: [" + sl::support::to_string(segment_size) + "]"));
+        preallocate_file(file_path, total);
+        results.resize(static_cast<size_t> (count));
+        for (uint32_t i = 0; i < results.size(); i++) {
+            auto& seg = results[i].segment;
+            seg.index = i;
+            seg.offset = static_cast<uint64_t> (i) * segment_size;
+            seg.length = std::min(segment_size, total - seg.offset);
+        }
+        return results;
+    }
+
+    uint64_t submit(const download_segment& seg) {
+        auto opts = options;
+        opts.method = "GET";
+        opts.polling_response_body_file_path = file_path;
+        if (ranged) {
+            opts.polling_response_body_file_offset = static_cast<int64_t> (seg.offset);
+            // ranges are byte offsets in the identity representation
+            opts.accept_encoding = "";
+            if (seg.length > 0) {
+                opts.dynamic_headers.emplace_back("Range", "bytes=" +
+                        sl::support::to_string(seg.offset) + "-" +
+                        sl::support::to_string(seg.offset + seg.length - 1));
+            }
+        } else {
+            opts.polling_response_body_file_offset = -1;
+        }
+        auto res = session->open_url(url, opts);
+        return res.get_id();
+    }
+
+    void record_attempt(download_segment_result& sr, resource& res) {
+        sr.attempts += 1;
+        sr.status_code = res.get_status_code();
+        sr.info = res.get_info();
+        sr.error = res.get_error();
+        bool received = sr.info.size_download_bytes >= 0 &&
+                static_cast<uint64_t> (sr.info.size_download_bytes) == sr.segment.length;
+        if (ranged) {
+            uint16_t expected = sr.segment.length > 0 ? 206 : 200;
+            sr.success = res.connection_successful() && sr.error.empty() &&
+                    expected == sr.status_code && received;
+        } else {
+            sr.success = res.connection_successful() && sr.error.empty() && 200 == sr.status_code;
+            if (sr.success && sr.info.size_download_bytes >= 0) {
+                sr.segment.length = static_cast<uint64_t> (sr.info.size_download_bytes);
+            }
+        }
+        if (!sr.success && sr.error.empty() && res.connection_successful() && 0 != sr.status_code) {
+            sr.error = "Unexpected response, status code: [" + sl::support::to_string(sr.status_code) + "]," +
+                    " bytes received: [" + sl::support::to_string(sr.info.size_download_bytes) + "]";
+        }
+    }
+};
+PIMPL_FORWARD_CONSTRUCTOR(parallel_download, (polling_session&)(const std::string&)(const std::string&)(uint64_t)(uint32_t)(request_options)(uint32_t)(progress_type), (), http_exception)
+PIMPL_FORWARD_METHOD(parallel_download, std::vector<download_segment_result>, run, (), (), http_exception)
+
+} // namespace
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * File:   parallel_job_driver.hpp
+ * Author: alex
+ *
+ * Created on October 19, 2026, 9:40 AM
+ */
+
+#ifndef STATICLIB_HTTP_PARALLEL_JOB_DRIVER_HPP
+#define STATICLIB_HTTP_PARALLEL_JOB_DRIVER_HPP
+
+#include <cstdint>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "staticlib/support.hpp"
+
+#include "staticlib/http/http_exception.hpp"
+#include "staticlib/http/polling_session.hpp"
+#include "staticlib/http/resource.hpp"
+
+namespace staticlib {
+namespace http {
+
+// runs a set of tasks (one request per attempt) on an idle polling session,
+// failed attempts are retried with bounded exponential backoff
+class parallel_job_driver {
+public:
+    // returns ID of the submitted request
+    using submit_type = std::function<uint64_t(uint32_t)>;
+    // returns true if the task succeeded
+    using record_type = std::function<bool(uint32_t, resource&)>;
+
+    static const uint32_t backoff_initial_millis = 100;
+    static const uint32_t backoff_max_millis = 10000;
+
+private:
+    using clock_type = std::chrono::steady_clock;
+
+    sl::support::observer_ptr<polling_session> session;
+    std::string job_name;
+    uint32_t max_concurrency;
+    uint32_t max_attempts;
+
+public:
+    parallel_job_driver(polling_session& session, const std::string& job_name,
+            uint32_t max_concurrency, uint32_t max_attempts) :
+    session(sl::support::make_observer_ptr(session)),
+    job_name(job_name.data(), job_name.length()),
+    max_concurrency(max_concurrency),
+    max_attempts(max_attempts) {
+        if (0 == max_concurrency) throw http_exception(TRACEMSG(
+                "Invalid zero 'max_concurrency' specified for " + this->job_name));
+        if (0 == max_attempts) throw http_exception(TRACEMSG(
+                "Invalid zero 'max_attempts' specified for " + this->job_name));
+    }
+
+    void check_idle() {
+        if (0 != session->enqueued_requests_count()) throw http_exception(TRACEMSG(
+                "Idle session is required for " + job_name + ", enqueued requests count: [" +
+                sl::support::to_string(session->enqueued_requests_count()) + "]"));
+    }
+
+    void run(uint32_t tasks_count, submit_type submit, record_type record) {
+        check_idle();
+        auto attempts = std::vector<uint32_t>(tasks_count, 0);
+        auto pending = std::deque<uint32_t>();
+        for (uint32_t i = 0; i < tasks_count; i++) {
+            pending.push_back(i);
+        }
+        // ready time -> task index
+        auto delayed = std::multimap<clock_type::time_point, uint32_t>();
+        // resource id -> task index
+        auto in_flight = std::map<uint64_t, uint32_t>();
+        try {
+            while (!pending.empty() || !delayed.empty() || !in_flight.empty()) {
+                auto now = clock_type::now();
+                while (!delayed.empty() && delayed.begin()->first <= now) {
+                    pending.push_back(delayed.begin()->second);
+                    delayed.erase(delayed.begin());
+                }
+                while (!pending.empty() && in_flight.size() < max_concurrency) {
+                    auto idx = pending.front();
+                    pending.pop_front();
+                    attempts[idx] += 1;
+                    auto id = submit(idx);
+                    in_flight.insert(std::make_pair(id, idx));
+                }
+                if (in_flight.empty()) {
+                    // only delayed retries left
+                    std::this_thread::sleep_until(delayed.begin()->first);
+                    continue;
+                }
+                auto finished = std::vector<resource>();
+                session->poll(wait_millis(delayed, now), 1, finished);
+                for (auto& res : finished) {
+                    auto it = in_flight.find(res.get_id());
+                    if (in_flight.end() == it) throw http_exception(TRACEMSG(
+                            "Unexpected request finished in session during " + job_name + "," +
+                            " url: [" + res.get_url() + "]"));
+                    auto idx = it->second;
+                    in_flight.erase(it);
+                    bool success = record(idx, res);
+                    if (!success && attempts[idx] < max_attempts && is_retriable(res)) {
+                        auto delay = backoff_delay_millis(attempts[idx], res);
+                        delayed.insert(std::make_pair(clock_type::now() + std::chrono::milliseconds(delay), idx));
+                    }
+                }
+            }
+        } catch (...) {
+            // running requests are completed to leave the session idle
+            while (0 != session->enqueued_requests_count()) {
+                session->poll();
+            }
+            throw;
+        }
+    }
+
+    static bool is_retriable(resource& res) {
+        uint16_t code = res.get_status_code();
+        return !res.connection_successful() || 0 == code ||
+                408 == code || 429 == code || code >= 500;
+    }
+
+    // doubled on every attempt, "Retry-After" (delay-seconds)
+    // is honoured, both are limited with "backoff_max_millis"
+    static uint32_t backoff_delay_millis(uint32_t attempts, resource& res) {
+        uint64_t delay = backoff_initial_millis;
+        for (uint32_t i = 1; i < attempts && delay < backoff_max_millis; i++) {
+            delay *= 2;
+        }
+        auto retry_after = find_header(res, "retry-after");
+        if (!retry_after.empty() && std::string::npos == retry_after.find_first_not_of("0123456789") &&
+                retry_after.length() <= 9) {
+            uint64_t secs = std::stoull(retry_after);
+            delay = std::max(delay, secs * 1000);
+        }
+        return static_cast<uint32_t> (std::min(delay, static_cast<uint64_t> (backoff_max_millis)));
+    }
+
+private:
+    // polling is interrupted when the next delayed retry is ready
+    static uint32_t wait_millis(const std::multimap<clock_type::time_point, uint32_t>& delayed,
+            clock_type::time_point now) {
+        if (delayed.empty()) {
+            return backoff_max_millis;
+        }
+        auto next = delayed.begin()->first;
+        if (next <= now) {
+            return 0;
+        }
+        auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(next - now).count();
+        return static_cast<uint32_t> (millis + 1);
+    }
+
+    static std::string find_header(resource& res, const std::string& name_lower) {
+        for (auto& en : res.get_headers()) {
+            if (name_lower.length() != en.first.length()) continue;
+            bool equal = true;
+            for (size_t i = 0; i < name_lower.length() && equal; i++) {
+                equal = name_lower[i] == std::tolower(static_cast<unsigned char> (en.first[i]));
+            }
+            if (equal) {
+                return en.second;
+            }
+        }
+        return "";
+    }
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_HTTP_PARALLEL_JOB_DRIVER_HPP */
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   parallel_upload.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 11:05 PM
+ */
+
+#include "staticlib/http/parallel_upload.hpp"
+
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+
+#include "staticlib/support.hpp"
+#include "staticlib/pimpl/forward_macros.hpp"
+
+#include "staticlib/http/file_body.hpp"
+
+#include "parallel_job_driver.hpp"
+
+namespace staticlib {
+namespace http {
+
+namespace { // anonymous
+
+using generator_type = std::function<upload_part_target(const upload_part&)>;
+
+} // namespace
+
+class parallel_upload::impl : public sl::pimpl::object::impl {
+    sl::support::observer_ptr<polling_session> session;
+    request_body body;
+    uint64_t part_size;
+    generator_type target_generator;
+    parallel_job_driver driver;
+
+public:
+    impl(polling_session& session, request_body body, uint64_t part_size, uint32_t max_concurrency,
+            generator_type target_generator, uint32_t max_attempts) :
+    session(sl::support::make_observer_ptr(session)),
+    body(std::move(body)),
+    part_size(part_size),
+    target_generator(std::move(target_generator)),
+    driver(session, "parallel upload", max_concurrency, max_attempts) {
+        if (!this->body.is_present()) throw http_exception(TRACEMSG(
+                "Invalid empty body specified for parallel upload"));
+        if (0 == part_size) throw http_exception(TRACEMSG(
+                "Invalid zero 'part_size' specified for parallel upload"));
+        if (!this->target_generator) throw http_exception(TRACEMSG(
+                "Invalid empty 'target_generator' specified for parallel upload"));
+    }
+
+    impl(polling_session& session, const std::string& file_path, uint64_t part_size, uint32_t max_concurrency,
+            generator_type target_generator, uint32_t max_attempts) :
+    impl(session, map_file_body(file_path), part_size, max_concurrency,
+            std::move(target_generator), max_attempts) { }
+
+    std::vector<upload_part_result> run(parallel_upload&) {
+        driver.check_idle();
+        auto results = create_parts();
+        // finished parts are not reported on error
+        driver.run(static_cast<uint32_t> (results.size()), [this, &results](uint32_t idx) {
+            return this->submit(results[idx].part);
+        }, [&results](uint32_t idx, resource& res) {
+            auto& pr = results[idx];
+            record_attempt(pr, res);
+            return pr.success;
+        });
+        return results;
+    }
+
+private:
+    std::vector<upload_part_result> create_parts() {
+        uint64_t total = body.size();
+        uint64_t count = total > 0 ? (total + part_size - 1) / part_size : 1;
+        if (count > std::numeric_limits<uint32_t>::max()) throw http_exception(TRACEMSG(
+                "Parallel upload parts count exceeded, body size: [" + sl::support::to_string(total) + "]," +
+                " part size: [" + sl::support::to_string(part_size) + "]"));
+        auto results = std::vector<upload_part_result>();
+        results.resize(static_cast<size_t> (count));
+        for (uint32_t i = 0; i < results.size(); i++) {
+            auto& part = results[i].part;
+            part.index = i;
+            part.offset = static_cast<uint64_t> (i) * part_size;
+            part.length = std::min(part_size, total - part.offset);
+        }
+        return results;
+    }
+
+    uint64_t submit(const upload_part& part) {
+        auto target = target_generator(part);
+        if ("" == target.options.method) {
+            target.options.method = "PUT";
+        }
+        auto res = session->open_url(target.url, body.slice(part.offset, part.length), target.options);
+        return res.get_id();
+    }
+
+    static void record_attempt(upload_part_result& pr, resource& res) {
+        pr.attempts += 1;
+        pr.status_code = res.get_status_code();
+        pr.headers = res.get_headers();
+        pr.error = res.get_error();
+        pr.success = res.connection_successful() && pr.error.empty() &&
+                pr.status_code >= 200 && pr.status_code < 300;
+    }
+};
+PIMPL_FORWARD_CONSTRUCTOR(parallel_upload, (polling_session&)(request_body)(uint64_t)(uint32_t)(generator_type)(uint32_t), (), http_exception)
+PIMPL_FORWARD_CONSTRUCTOR(parallel_upload, (polling_session&)(const std::string&)(uint64_t)(uint32_t)(generator_type)(uint32_t), (), http_exception)
+PIMPL_FORWARD_METHOD(parallel_upload, std::vector<upload_part_result>, run, (), (), http_exception)
+
+} // namespace
+}
@@ -37,7 +37,11 @@
 #include "staticlib/http/resource_info.hpp"
 #include "staticlib/http/http_exception.hpp"
 
+#include "curl_info.hpp"
+#include "http_probes.hpp"
+#include "request_timeline.hpp"
 #include "resource_impl.hpp"
+#include "response_body_buffer.hpp"
 
 namespace staticlib {
 namespace http {
@@ -54,11 +58,12 @@ class polling_resource::impl : public resource::impl {
     std::string url;
     bool empty;
 
-    resource_info info;
+    curl_info_snapshot info;
+    resource_timeline timeline;
     uint16_t status_code = 0;
     std::vector<std::pair<std::string, std::string>> response_headers;
-    std::vector<char> buf;
-    size_t buf_idx = 0;
+    response_body_buffer buf;
+    uint64_t buf_idx = 0;
     std::string error;
 
 public:
@@ -70,15 +75,16 @@ public:
     empty(true) { }
 
     impl(uint64_t resource_id, const request_options& req_options, const std::string& url,
-            resource_info&& info, uint16_t status_code,
+            curl_info_snapshot&& info, const resource_timeline& timeline, uint16_t status_code,
             std::vector<std::pair<std::string, std::string>>&& response_headers,
-            std::vector<char>&& data, const std::string& error_message):
+            response_body_buffer&& data, const std::string& error_message):
     resource::impl(),
     id(resource_id),
     request_opts(req_options),
     url(url.data(), url.length()),
     empty(false),
     info(std::move(info)),
+    timeline(timeline),
     status_code(status_code),
     response_headers(std::move(response_headers)),
     buf(std::move(data)),
@@ -92,13 +98,14 @@ public:
         if (!empty) {
             // return from buffer
             if (buf_idx < buf.size()) {
-                size_t ulen = span.size();
-                size_t avail = buf.size() - buf_idx;
-                size_t reslen = avail <= ulen ? avail : ulen;
-                std::memcpy(span.data(), buf.data() + buf_idx, reslen);
+                size_t reslen = buf.read_at(buf_idx, span);
                 buf_idx += reslen;
+                STATICLIB_HTTP_PROBE2(consumer_read, id, reslen);
                 return static_cast<std::streamsize> (reslen);
             } else {
+                if (request_opts.record_timeline && -1 == timeline.consumer_eof) {
+                    timeline.consumer_eof = timeline_now();
+                }
                 return std::char_traits<char>::eof();
             }
         } else {
@@ -115,7 +122,11 @@ public:
     }
 
     virtual resource_info get_info(const resource&) const override {
-        return info;
+        return info.to_resource_info(url);
+    }
+
+    virtual resource_timeline get_timeline(const resource&) const override {
+        return timeline;
     }
 
     virtual const std::vector<std::pair<std::string, std::string>>& get_headers(const resource&) const override {
@@ -146,19 +157,30 @@ public:
     virtual const std::string& get_error(const resource&) const override {
         return error;
     }
+
+    virtual sl::io::span<const char> body_view(resource&) override {
+        return buf.flatten();
+    }
+
+    virtual std::vector<char> take_body(resource&) override {
+        return buf.take();
+    }
 };
 PIMPL_FORWARD_CONSTRUCTOR(polling_resource, (uint64_t)(const request_options&)(const std::string&), (), http_exception)
-PIMPL_FORWARD_CONSTRUCTOR(polling_resource, (uint64_t)(const request_options&)(const std::string&)(resource_info&&)(uint16_t)(headers_type&&)(std::vector<char>&&)(const std::string&), (), http_exception)
+PIMPL_FORWARD_CONSTRUCTOR(polling_resource, (uint64_t)(const request_options&)(const std::string&)(curl_info_snapshot&&)(const resource_timeline&)(uint16_t)(headers_type&&)(response_body_buffer&&)(const std::string&), (), http_exception)
 PIMPL_FORWARD_METHOD(polling_resource, std::streamsize, read, (sl::io::span<char>), (), http_exception)
 PIMPL_FORWARD_METHOD(polling_resource, const std::string&, get_url, (), (const), http_exception)
 PIMPL_FORWARD_METHOD(polling_resource, uint16_t, get_status_code, (), (const), http_exception)
 PIMPL_FORWARD_METHOD(polling_resource, resource_info, get_info, (), (const), http_exception)
+PIMPL_FORWARD_METHOD(polling_resource, resource_timeline, get_timeline, (), (const), http_exception)
 PIMPL_FORWARD_METHOD(polling_resource, const headers_type&, get_headers, (), (const), http_exception)
 PIMPL_FORWARD_METHOD(polling_resource, const std::string&, get_header, (const std::string&), (const), http_exception)
 PIMPL_FORWARD_METHOD(polling_resource, bool, connection_successful, (), (const), http_exception)
 PIMPL_FORWARD_METHOD(polling_resource, uint64_t, get_id, (), (const), http_exception)
 PIMPL_FORWARD_METHOD(polling_resource, const request_options&, get_request_options, (), (const), http_exception)
 PIMPL_FORWARD_METHOD(polling_resource, const std::string&, get_error, (), (const), http_exception)
+PIMPL_FORWARD_METHOD(polling_resource, sl::io::span<const char>, body_view, (), (), http_exception)
+PIMPL_FORWARD_METHOD(polling_resource, std::vector<char>, take_body, (), (), http_exception)
 
 } // namespace
 }
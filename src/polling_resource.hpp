@@ -31,6 +31,10 @@
 namespace staticlib {
 namespace http {
 
+// forward decl
+class curl_info_snapshot;
+class response_body_buffer;
+
 class polling_resource : public resource {
 protected:
     class impl;
@@ -40,9 +44,9 @@ public:
 
     polling_resource(uint64_t resource_id, const request_options& req_options, const std::string& url);
 
-    polling_resource(uint64_t resource_id, const request_options& req_options, const std::string& url, resource_info&& info, uint16_t status_code,
+    polling_resource(uint64_t resource_id, const request_options& req_options, const std::string& url, curl_info_snapshot&& info, const resource_timeline& timeline, uint16_t status_code,
             std::vector<std::pair<std::string, std::string>>&& response_headers,
-            std::vector<char>&& data, const std::string& error_message);
+            response_body_buffer&& data, const std::string& error_message);
 
     virtual std::streamsize read(sl::io::span<char> span) override;
 
@@ -52,6 +56,8 @@ public:
 
     virtual resource_info get_info() const override;
 
+    virtual resource_timeline get_timeline() const override;
+
     virtual const std::vector<std::pair<std::string, std::string>>& get_headers() const override;
 
     virtual const std::string& get_header(const std::string& name) const override;
@@ -64,6 +70,10 @@ public:
 
     virtual const std::string& get_error() const override;
 
+    virtual sl::io::span<const char> body_view() override;
+
+    virtual std::vector<char> take_body() override;
+
 };
 
 } // namespace
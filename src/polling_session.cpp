@@ -23,10 +23,14 @@
 #include "staticlib/http/polling_session.hpp"
 
 #include <cstdint>
+#include <algorithm>
 #include <chrono>
 #include <condition_variable>
+#include <limits>
+#include <atomic>
 #include <map>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <thread>
 #include <vector>
@@ -36,12 +40,18 @@
 #include "staticlib/support.hpp"
 #include "staticlib/io.hpp"
 #include "staticlib/pimpl/forward_macros.hpp"
-#include "staticlib/tinydir.hpp"
 
 #include "session_impl.hpp"
+#include "async_file_writer.hpp"
 #include "curl_headers.hpp"
 #include "curl_utils.hpp"
+#include "http_probes.hpp"
+#include "mpsc_queue.hpp"
 #include "polling_resource.hpp"
+#include "positional_file_sink.hpp"
+#include "request_body_reader.hpp"
+#include "request_timeline.hpp"
+#include "response_body_buffer.hpp"
 #include "running_request_pipe.hpp"
 #include "running_request.hpp"
 
@@ -50,6 +60,17 @@ namespace http {
 
 namespace { // anonymous
 
+// response body chunks are coalesced before
+// they are queued to file writer threads
+const size_t file_write_batch_size = 256 * 1024;
+
+// up to 4MB of free body blocks are kept by session
+const size_t max_pooled_blocks = 64;
+
+// larger bodies are collected in blocks, even if
+// their size is known from "Content-Length"
+const uint64_t max_reserved_body_size = 256 * 1024 * 1024;
+
 class request {
     uint64_t id;
 
@@ -59,14 +80,30 @@ class request {
     std::string url;
     request_options options;
     std::unique_ptr<std::istream> post_data;
+    request_body_reader body;
     curl_headers request_headers;
 
     // run details
-    resource_info info;
+    request_timeline timeline;
     uint16_t status_code = 0;
     std::vector<std::pair<std::string, std::string>> response_headers;
-    std::vector<char> buf;
-    std::unique_ptr<sl::tinydir::file_sink> response_body_file_sink;
+    response_body_buffer buf;
+    std::unique_ptr<positional_file_sink> response_body_file_sink;
+    sl::support::observer_ptr<async_file_writer> file_writer;
+    std::shared_ptr<async_file_stream> response_body_file_stream;
+    std::vector<char> file_batch;
+    // "Range" request written at file offset
+    int64_t range_first = -1;
+    uint64_t range_length = 0;
+    uint64_t range_written = 0;
+    bool range_checked = false;
+    bool paused = false;
+    // streaming delivery
+    std::vector<char> stream_batch;
+    size_t headers_block_start = 0;
+    bool location_received = false;
+    bool headers_event_pending = false;
+    uint16_t stream_status_code = 0;
     std::string error;
 
     // no-copy
@@ -75,52 +112,163 @@ class request {
 
 public:
     request(uint64_t request_id, std::unique_ptr<CURL, curl_easy_deleter> handle, const std::string& url,
-            std::unique_ptr<std::istream> post_data, request_options opts):
+            std::unique_ptr<std::istream> post_data, request_body body, request_options opts,
+            request_timeline timeline, curl_headers_cache& headers_cache, async_file_writer* file_writer,
+            std::shared_ptr<body_block_pool> block_pool):
     id(request_id),
     handle(std::move(handle)),
     url(url.data(), url.length()),
     options(std::move(opts)),
-    post_data(std::move(post_data)) {
-        if (!this->options.polling_response_body_file_path.empty()) {
-            this->response_body_file_sink = sl::support::make_unique<sl::tinydir::file_sink>(
-                    this->options.polling_response_body_file_path);
+    post_data(std::move(post_data)),
+    body(std::move(body)),
+    request_headers(headers_cache),
+    timeline(std::move(timeline)),
+    buf(std::move(block_pool), this->options.polling_response_body_spill_threshold_bytes,
+            this->options.polling_response_body_spill_dir),
+    file_writer(file_writer) {
+        // handle is already added to multi at this point
+        this->timeline.mark_multi_added();
+        STATICLIB_HTTP_PROBE1(multi_add, id);
+        auto& path = this->options.polling_response_body_file_path;
+        if (!path.empty() && !this->options.polling_streaming) {
+            auto offset = this->options.polling_response_body_file_offset;
+            if (offset < 0) {
+                // create or truncate
+                preallocate_file(path, 0);
+                offset = 0;
+            }
+            if (nullptr != this->file_writer.get()) {
+                this->response_body_file_stream = std::make_shared<async_file_stream>(path,
+                        static_cast<uint64_t> (offset));
+            } else {
+                this->response_body_file_sink = sl::support::make_unique<positional_file_sink>(path,
+                        static_cast<uint64_t> (offset));
+            }
+            if (this->options.polling_response_body_file_offset >= 0) {
+                parse_range_header();
+            }
         }
-        apply_curl_options(this, this->url, this->options, this->post_data, this->request_headers, this->handle);
+        apply_curl_options(this, this->url, this->options, this->post_data, this->body,
+                this->request_headers, this->handle);
     }
 
     size_t write_headers(char* buffer, size_t size, size_t nitems) {
+        timeline.mark_first_header();
         if (status_code < 200) {
             curl_info ci(handle.get());
             this->status_code = static_cast<uint16_t>(ci.getinfo_long(CURLINFO_RESPONSE_CODE));
+            STATICLIB_HTTP_PROBE2(first_header, id, status_code);
         }
         size_t len = size*nitems;
         auto opt = curl_parse_header(buffer, len);
         if (opt) {
+            if (status_code >= 200 && status_code < 300 && curl_header_name_equals("content-length", opt.value().first)) {
+                reserve_body(opt.value().second);
+            }
+            if (curl_header_name_equals("location", opt.value().first)) {
+                this->location_received = true;
+            }
             response_headers.emplace_back(std::move(opt.value()));
+        } else if (options.polling_streaming && curl_header_is_blank(buffer, len)) {
+            end_headers_block();
         }
         return len;
     }
 
     size_t write_data(char* buffer, size_t size, size_t nitems) {
+        timeline.mark_first_byte();
         size_t len = size*nitems;
-        if (nullptr == response_body_file_sink.get()) {
-            size_t buf_size = buf.size();
-            size_t max_size = options.polling_response_body_max_size_bytes;
+        STATICLIB_HTTP_PROBE2(write_data, id, len);
+        if (options.polling_streaming) {
+            return write_data_stream(buffer, len);
+        } else if (range_first >= 0 && !accept_range_data(len)) {
+            // must not overwrite other ranges of the file
+            return 0;
+        } else if (nullptr != response_body_file_stream.get()) {
+            return write_data_async(buffer, len);
+        } else if (nullptr == response_body_file_sink.get()) {
+            uint64_t buf_size = buf.size();
+            uint64_t max_size = options.polling_response_body_max_size_bytes;
             if (max_size > 0 && buf_size + len > max_size) {
                 this->status_code = 0;
                 this->append_error(std::string() + "response body size exceeded, " +
                         "limit: [" + sl::support::to_string(max_size) + "]");
                 return 0;
             }
-            buf.resize(buf_size + len);
-            std::memcpy(buf.data() + buf_size, buffer, len);
+            try {
+                buf.append(buffer, len);
+            } catch (const std::exception& e) {
+                this->append_error(e.what());
+                return 0;
+            }
         } else {
-            sl::io::write_all(*response_body_file_sink, {buffer, len});
+            response_body_file_sink->write({buffer, len});
         }
         return len;
     }
 
+    bool is_paused() {
+        return paused;
+    }
+
+    bool is_streaming() {
+        return options.polling_streaming;
+    }
+
+    void unpause_if_ready() {
+        // streaming batch is taken by every poll
+        bool ready = options.polling_streaming ? stream_batch.empty() : file_writer->has_capacity();
+        if (ready) {
+            // write callback may be called from 'curl_easy_pause'
+            // and may pause the transfer again
+            this->paused = false;
+            timeline.mark_unpaused();
+            STATICLIB_HTTP_PROBE1(unpause, id);
+            auto err = curl_easy_pause(handle.get(), CURLPAUSE_CONT);
+            if (CURLE_OK != err) throw http_exception(TRACEMSG(
+                    "cURL unpause error: [" + curl_easy_strerror(err) + "], url: [" + url + "]"));
+        }
+    }
+
+    // returns true if completion must be awaited
+    // before converting this request into resource
+    bool close_file_stream() {
+        if (nullptr == response_body_file_stream.get()) {
+            return false;
+        }
+        file_writer->write(response_body_file_stream, std::move(file_batch));
+        file_writer->close(response_body_file_stream, options.polling_response_body_file_sync);
+        return true;
+    }
+
+    bool file_stream_complete() {
+        return file_writer->is_complete(response_body_file_stream);
+    }
+
+    void collect_events(std::vector<polling_event>& events) {
+        if (headers_event_pending) {
+            auto ev = polling_event();
+            ev.type = polling_event_type::headers_ready;
+            ev.resource_id = id;
+            ev.status_code = stream_status_code;
+            ev.headers.assign(response_headers.begin() + headers_block_start, response_headers.end());
+            events.emplace_back(std::move(ev));
+            this->headers_event_pending = false;
+        }
+        if (!stream_batch.empty()) {
+            auto ev = polling_event();
+            ev.type = polling_event_type::data_available;
+            ev.resource_id = id;
+            ev.data = std::move(stream_batch);
+            events.emplace_back(std::move(ev));
+            this->stream_batch = std::vector<char>();
+        }
+    }
+
     size_t read_data(char* buffer, size_t size, size_t nitems) {
+        if (body.get_body().is_present()) {
+            return body.read(buffer, size * nitems);
+        }
         std::streamsize len = static_cast<std::streamsize> (size * nitems);
         sl::io::streambuf_source src{post_data->rdbuf()};
         std::streamsize read = sl::io::read_all(src,{buffer, len});
@@ -136,76 +284,359 @@ public:
         error.append(msg);
     }
 
-    polling_resource to_resource() {
-        auto info = curl_collect_info(handle.get());
+private:
+    // single "bytes=first-[last]" range is supported
+    void parse_range_header() {
+        auto value = std::string();
+        for (auto& pa : options.dynamic_headers) {
+            if (curl_header_name_equals("range", pa.first)) value = pa.second;
+        }
+        for (auto& pa : options.headers) {
+            if (value.empty() && curl_header_name_equals("range", pa.first)) value = pa.second;
+        }
+        static const std::string prefix = "bytes=";
+        if (0 != value.find(prefix)) return;
+        auto spec = value.substr(prefix.length());
+        auto dash = spec.find('-');
+        auto first = spec.substr(0, dash);
+        auto last = std::string::npos != dash ? spec.substr(dash + 1) : std::string();
+        if (first.empty() || std::string::npos == dash ||
+                std::string::npos != first.find_first_not_of("0123456789") ||
+                std::string::npos != last.find_first_not_of("0123456789")) return;
+        try {
+            auto first_num = std::stoull(first);
+            auto last_num = last.empty() ? 0 : std::stoull(last);
+            if (!last.empty() && last_num < first_num) return;
+            this->range_first = static_cast<int64_t> (first_num);
+            this->range_length = last.empty() ? 0 : last_num - first_num + 1;
+        } catch (const std::exception&) {
+            // not checked
+        }
+    }
+
+    // response body is accepted only for "206" with the requested range
+    bool accept_range_data(size_t len) {
+        if (!range_checked) {
+            curl_info ci(handle.get());
+            long code = ci.getinfo_long(CURLINFO_RESPONSE_CODE);
+            auto content_range = std::string();
+            for (auto it = response_headers.rbegin(); it != response_headers.rend(); ++it) {
+                if (curl_header_name_equals("content-range", it->first)) {
+                    content_range = it->second;
+                    break;
+                }
+            }
+            auto expected = "bytes " + sl::support::to_string(range_first) + "-";
+            if (206 != code || 0 != content_range.find(expected)) {
+                this->append_error("Unexpected response to a range request, status code: [" +
+                        sl::support::to_string(code) + "], 'Content-Range': [" + content_range + "]," +
+                        " expected: [" + expected + "...]");
+                return false;
+            }
+            this->range_checked = true;
+        }
+        if (range_length > 0 && range_written + len > range_length) {
+            this->append_error("Range response body exceeds the requested length: [" +
+                    sl::support::to_string(range_length) + "]");
+            return false;
+        }
+        this->range_written += len;
+        return true;
+    }
+
+    void reserve_body(const std::string& content_length) {
+        if (!options.polling_response_body_file_path.empty() || options.polling_streaming || buf.size() > 0) return;
+        // "Content-Length" describes the body that is not sent
+        if ("HEAD" == options.method) return;
+        if (content_length.empty() || std::string::npos != content_length.find_first_not_of("0123456789")) return;
+        uint64_t cl = 0;
+        try {
+            cl = std::stoull(content_length);
+        } catch (const std::exception&) {
+            return;
+        }
+        uint64_t max_size = options.polling_response_body_max_size_bytes;
+        if (max_size > 0 && cl > max_size) return;
+        uint64_t threshold = options.polling_response_body_spill_threshold_bytes;
+        bool spills = threshold > 0 && cl > threshold;
+        if (cl > max_reserved_body_size && !spills) return;
+        try {
+            buf.reserve(cl);
+        } catch (const std::exception& e) {
+            // body is collected in blocks then
+            (void) e;
+        }
+    }
+
+    size_t write_data_async(char* buffer, size_t len) {
+        auto err = file_writer->get_error(response_body_file_stream);
+        if (!err.empty()) {
+            this->append_error(err);
+            return 0;
+        }
+        if (!file_writer->has_capacity()) {
+            return pause();
+        }
+        file_batch.insert(file_batch.end(), buffer, buffer + len);
+        if (file_batch.size() >= file_write_batch_size) {
+            file_writer->write(response_body_file_stream, std::move(file_batch));
+            file_batch = std::vector<char>();
+        }
+        return len;
+    }
+
+    size_t write_data_stream(char* buffer, size_t len) {
+        // single chunk larger than window is accepted
+        if (!stream_batch.empty() && stream_batch.size() + len > options.polling_streaming_window_bytes) {
+            return pause();
+        }
+        stream_batch.insert(stream_batch.end(), buffer, buffer + len);
+        return len;
+    }
+
+    size_t pause() {
+        // data is passed again on unpause
+        this->paused = true;
+        timeline.mark_paused();
+        STATICLIB_HTTP_PROBE1(pause, id);
+        return CURL_WRITEFUNC_PAUSE;
+    }
+
+    void end_headers_block() {
+        curl_info ci(handle.get());
+        auto code = static_cast<uint16_t> (ci.getinfo_long(CURLINFO_RESPONSE_CODE));
+        bool redirect = options.followlocation && location_received && code >= 300 && code < 400;
+        if (code >= 200 && !redirect) {
+            this->stream_status_code = code;
+            this->headers_event_pending = true;
+        } else {
+            // informational and followed responses are not reported
+            this->headers_block_start = response_headers.size();
+        }
+        this->location_received = false;
+    }
+
+public:
+    polling_resource to_resource(metrics_collector& metrics, CURLcode result) {
+        timeline.mark_completed();
+        auto info = curl_collect_info(handle.get(), url);
+        metrics.on_finished(info, result, false);
+        STATICLIB_HTTP_PROBE2(complete, id, static_cast<int> (result));
         if (nullptr != response_body_file_sink.get()) {
+            if (options.polling_response_body_file_sync) {
+                try {
+                    response_body_file_sink->sync();
+                } catch (const std::exception& e) {
+                    append_error(e.what());
+                }
+            }
             response_body_file_sink.reset();
         }
-        return polling_resource(id, options, url, std::move(info), status_code,
+        if (nullptr != response_body_file_stream.get()) {
+            auto err = file_writer->get_error(response_body_file_stream);
+            if (!err.empty()) {
+                append_error(err);
+            }
+            response_body_file_stream.reset();
+        }
+        try {
+            buf.finish();
+        } catch (const std::exception& e) {
+            append_error(e.what());
+        }
+        return polling_resource(id, options, url, std::move(info), timeline.get(), status_code,
                 std::move(response_headers), std::move(buf), error);
     }
 };
 
+// request passed from other thread
+struct submission {
+    uint64_t id;
+    std::string url;
+    std::unique_ptr<std::istream> post_data;
+    request_body body;
+    request_options options;
+    request_timeline timeline;
+};
+
 } // namespace
 
 class polling_session::impl : public session::impl {
     std::map<int64_t, std::unique_ptr<request>> queue;
+    // added to queue at the start of the poll round
+    mpsc_queue<submission> submissions;
+    std::atomic<size_t> submissions_count;
+    // enqueued and submitted
+    std::atomic<size_t> streaming_count;
+    // finished transfers, waiting for file writes
+    std::vector<std::pair<std::unique_ptr<request>, CURLcode>> finishing;
+    std::unique_ptr<async_file_writer> file_writer;
+    std::shared_ptr<body_block_pool> block_pool;
 
 public:
     impl(session_options opts) :
-    session::impl(opts) { }
+    session::impl(opts),
+    submissions_count(0),
+    streaming_count(0),
+    block_pool(std::make_shared<body_block_pool>(max_pooled_blocks)) {
+        if (options.polling_file_writer_threads > 0) {
+            this->file_writer = sl::support::make_unique<async_file_writer>(options.polling_file_writer_threads,
+                    options.polling_file_writer_max_queued_bytes);
+        }
+    }
 
     ~impl() STATICLIB_NOEXCEPT {
     }
 
     resource open_url(polling_session&, const std::string& url,
             std::unique_ptr<std::istream> post_data, request_options opts) {
-        if ("" == opts.method) {
-            opts.method = "POST";
-        }
+        return enqueue_request(url, std::move(post_data), request_body(), std::move(opts));
+    }
 
-        if (queue.size() >= options.requests_queue_max_size) throw http_exception(TRACEMSG(
-                "HTTP queue max size exceeded, url: [" + url + "]" +
-                " queue size: [" + sl::support::to_string(queue.size()) + "]"));
+    resource open_url(polling_session&, const std::string& url,
+            request_body body, request_options opts) {
+        return enqueue_request(url, std::unique_ptr<std::istream>(), std::move(body), std::move(opts));
+    }
 
-        // create easy handle
-        auto easy_handle = std::unique_ptr<CURL, curl_easy_deleter>(
-                curl_easy_init(), curl_easy_deleter(this->handle.get()));
-        if (nullptr == easy_handle.get()) throw http_exception(TRACEMSG(
-                "Error creating cURL handle, url: [" + url + "]," +
-                " queue size: [" + sl::support::to_string(queue.size()) + "]"));
+    resource submit_url(polling_session&, const std::string& url, request_options opts) {
+        if ("" == opts.method) {
+            opts.method = "GET";
+        }
+        auto post_data = std::unique_ptr<std::istream>(new std::istringstream(""));
+        return submit(url, std::move(post_data), request_body(), std::move(opts));
+    }
 
-        // enqueue request
-        CURLMcode errm = curl_multi_add_handle(handle.get(), easy_handle.get());
-        if (errm != CURLM_OK) throw http_exception(TRACEMSG(
-                "cURL multi_add error: [" + curl_multi_strerror(errm) + "], url: [" + url + "]"));
+    resource submit_url(polling_session&, const std::string& url, request_body body, request_options opts) {
+        return submit(url, std::unique_ptr<std::istream>(), std::move(body), std::move(opts));
+    }
 
-        auto id = increment_resource_id();
-        auto key = reinterpret_cast<int64_t>(easy_handle.get());
-        auto req = sl::support::make_unique<request>(id, std::move(easy_handle), url, std::move(post_data), opts);
-        auto inserted = queue.insert(std::make_pair(key, std::move(req)));
-        if (!inserted.second) throw http_exception(TRACEMSG(
-                "Error enqueuing cURL handle, url: [" + url + "]," +
-                " queue size: [" + sl::support::to_string(queue.size()) + "]"));
+    void wakeup(polling_session&) {
+        wakeup_internal();
+    }
 
-        // return empty resource
-        return polling_resource(id, opts, url);
+    void wakeup_internal() {
+#if LIBCURL_VERSION_NUM >= 0x074400
+        CURLMcode err = curl_multi_wakeup(this->handle.get());
+        if (CURLM_OK != err) throw http_exception(TRACEMSG(
+                "cURL multi_wakeup error: [" + curl_multi_strerror(err) + "]"));
+#endif // LIBCURL_VERSION_NUM
     }
 
     std::vector<resource> poll(polling_session&) {
         auto results = std::vector<resource>();
-        
+        poll_round(results, nullptr, -1);
+        return results;
+    }
+
+    std::vector<resource> poll(polling_session&, std::vector<polling_event>& events) {
+        auto results = std::vector<resource>();
+        poll_round(results, std::addressof(events), -1);
+        return results;
+    }
+
+    size_t poll(polling_session&, uint32_t timeout_millis, size_t min_completions,
+            std::vector<resource>& out) {
+        return poll_timed(timeout_millis, min_completions, out, nullptr);
+    }
+
+    size_t poll(polling_session&, uint32_t timeout_millis, size_t min_completions,
+            std::vector<resource>& out, std::vector<polling_event>& events) {
+        return poll_timed(timeout_millis, min_completions, out, std::addressof(events));
+    }
+
+    size_t enqueued_requests_count(polling_session&) {
+        return enqueued_requests_count_internal();
+    }
+
+    size_t poll_timed(uint32_t timeout_millis, size_t min_completions,
+            std::vector<resource>& out, std::vector<polling_event>* events) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_millis);
+        size_t out_start = out.size();
+        size_t events_start = nullptr != events ? events->size() : 0;
+        bool idle = 0 == enqueued_requests_count_internal();
+        for (;;) {
+            auto now = std::chrono::steady_clock::now();
+            int64_t remaining = now < deadline ?
+                    std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count() : 0;
+            remaining = std::min(remaining, static_cast<int64_t> (std::numeric_limits<int>::max()));
+            poll_round(out, events, static_cast<int> (remaining));
+            size_t enqueued = enqueued_requests_count_internal();
+            // idle wait may be shorter than the timeout, when multi_wakeup is not available
+            idle = idle && 0 == enqueued && out.size() == out_start;
+            if (out.size() - out_start >= min_completions ||
+                    (nullptr != events && events->size() > events_start) ||
+                    (0 == enqueued && !idle) ||
+                    std::chrono::steady_clock::now() >= deadline) {
+                break;
+            }
+        }
+        return out.size() - out_start;
+    }
+
+    size_t enqueued_requests_count_internal() {
+        return queue.size() + finishing.size() + submissions_count.load(std::memory_order_acquire);
+    }
+
+    // negative wait_millis: single select with timeouts from session options,
+    // null events: caller cannot receive streaming events
+    void poll_round(std::vector<resource>& results, std::vector<polling_event>* events, int wait_millis) {
+        add_submissions(results);
+
+        // streaming data must not be dropped
+        size_t streaming = streaming_count.load(std::memory_order_acquire);
+        if (nullptr == events && streaming > 0) throw http_exception(TRACEMSG(
+                "Requests with 'polling_streaming' enabled must be polled with" +
+                " the 'poll' overload that accepts 'events' list," +
+                " streaming requests count: [" + sl::support::to_string(streaming) + "]"));
+
         if (0 == queue.size()) {
-            return results;
+            if (!finishing.empty()) {
+                auto wait = wait_millis >= 0 ? static_cast<uint32_t> (wait_millis) : options.fdset_timeout_millis;
+                file_writer->await_completion(std::chrono::milliseconds(wait));
+                collect_finishing(results);
+            } else if (wait_millis > 0) {
+                // idle, wait for submissions from other threads
+                int idle_wait = wait_millis;
+#if LIBCURL_VERSION_NUM < 0x074400
+                // no multi_wakeup, submissions are noticed on the next round
+                idle_wait = std::min(idle_wait, static_cast<int> (options.fdset_timeout_millis));
+#endif // LIBCURL_VERSION_NUM
+                call_wait(idle_wait);
+                add_submissions(results);
+            }
+            if (0 == queue.size()) {
+                return;
+            }
         }
- 
-        // timeout
-        auto timeout = call_timeout();
 
-        // select
-        auto can_perform = call_select(timeout);
-        if (!can_perform) {
-            return results;
+        // resume transfers paused on file writes or streaming window
+        bool paused = false;
+        for (auto& pa : queue) {
+            if (pa.second->is_paused()) {
+                pa.second->unpause_if_ready();
+                paused = paused || pa.second->is_paused();
+            }
+        }
+ 
+        if (wait_millis < 0) {
+            // timeout
+            auto timeout = call_timeout();
+
+            // select
+            auto can_perform = call_select(timeout);
+            if (!can_perform) {
+                return;
+            }
+        } else {
+            // file writes completion does not wake up the wait
+            if (paused) {
+                wait_millis = std::min(wait_millis, static_cast<int> (options.fdset_timeout_millis));
+            }
+#if LIBCURL_VERSION_NUM < 0x074400
+            // no multi_wakeup, submissions are noticed on the next round
+            wait_millis = std::min(wait_millis, static_cast<int> (options.fdset_timeout_millis));
+#endif // LIBCURL_VERSION_NUM
+            call_wait(wait_millis);
         }
 
         // perform
@@ -214,13 +645,30 @@ public:
         // collect finished
         if (active < queue.size()) {
             CURL* easy_handle = nullptr;
-            while(nullptr != (easy_handle = call_info())) {
+            CURLcode result = CURLE_OK;
+            while(nullptr != (easy_handle = call_info(result))) {
                 auto key = reinterpret_cast<int64_t>(easy_handle);
                 auto req = dequeue_request(key);
-                auto res = req->to_resource();
+                if (req->is_streaming()) {
+                    req->collect_events(*events);
+                    streaming_count.fetch_sub(1, std::memory_order_acq_rel);
+                }
+                if (req->close_file_stream()) {
+                    finishing.emplace_back(std::move(req), result);
+                    continue;
+                }
+                auto res = req->to_resource(metrics, result);
                 results.emplace_back(std::move(res));
             }
         }
+        collect_finishing(results);
+
+        // report running streaming transfers
+        if (nullptr != events) {
+            for (auto& pa : queue) {
+                pa.second->collect_events(*events);
+            }
+        }
 
         // sanity check
         if (queue.size() != active) throw http_exception(TRACEMSG(
@@ -228,12 +676,18 @@ public:
                 " active transfers count: [" + sl::support::to_string(active) + "],"
                 " queue size: [" + sl::support::to_string(queue.size()) + "]," +
                 " results count: [" + sl::support::to_string(results.size()) + "]"));
-
-        return results;
     }
 
-    size_t enqueued_requests_count(polling_session&) {
-        return queue.size();
+    void collect_finishing(std::vector<resource>& results) {
+        for (auto it = finishing.begin(); it != finishing.end();) {
+            if (it->first->file_stream_complete()) {
+                auto res = it->first->to_resource(metrics, it->second);
+                results.emplace_back(std::move(res));
+                it = finishing.erase(it);
+            } else {
+                ++it;
+            }
+        }
     }
 
     struct timeval call_timeout() {
@@ -266,6 +720,29 @@ public:
         return -1 != err_select;
     }
 
+    void call_wait(int wait_millis) {
+        int numfds = 0;
+#if LIBCURL_VERSION_NUM >= 0x074200
+        // sleeps for the whole timeout even if there is nothing to wait on
+        CURLMcode err = curl_multi_poll(this->handle.get(), nullptr, 0, wait_millis, std::addressof(numfds));
+        if (CURLM_OK != err) throw http_exception(TRACEMSG(
+                "cURL multi_poll error: [" + curl_multi_strerror(err) + "]"));
+#else // LIBCURL_VERSION_NUM
+        auto start = std::chrono::steady_clock::now();
+        CURLMcode err = curl_multi_wait(this->handle.get(), nullptr, 0, wait_millis, std::addressof(numfds));
+        if (CURLM_OK != err) throw http_exception(TRACEMSG(
+                "cURL multi_wait error: [" + curl_multi_strerror(err) + "]"));
+        // multi_wait returns immediately when there are no sockets to wait on,
+        // running transfers must not be delayed by sleeping
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        if (0 == numfds && queue.empty() && elapsed < wait_millis) {
+            auto sleep = std::min(static_cast<uint32_t> (wait_millis - elapsed), this->options.fdset_timeout_millis);
+            std::this_thread::sleep_for(std::chrono::milliseconds(sleep));
+        }
+#endif // LIBCURL_VERSION_NUM
+    }
+
     size_t call_perform() {
         int active = 0;
         CURLMcode err = curl_multi_perform(this->handle.get(), std::addressof(active));
@@ -274,7 +751,7 @@ public:
         return static_cast<size_t>(active);
     }
 
-    CURL* call_info() {
+    CURL* call_info(CURLcode& result) {
         int msg_count = -1;
         auto msg = curl_multi_info_read(this->handle.get(), std::addressof(msg_count));
         if (nullptr == msg) {
@@ -283,9 +760,107 @@ public:
         if (CURLMSG_DONE != msg->msg) throw http_exception(TRACEMSG(
                 "cURL multi_info_read error, msg_count: [" + sl::support::to_string(msg_count) + "]"));
         // todo: collect and append error
+        result = msg->data.result;
         return msg->easy_handle;
     }
 
+    resource enqueue_request(const std::string& url, std::unique_ptr<std::istream> post_data,
+            request_body body, request_options opts) {
+        if ("" == opts.method) {
+            opts.method = "POST";
+        }
+        auto id = increment_resource_id();
+        auto timeline = request_timeline(opts.record_timeline);
+        timeline.mark_submitted();
+        add_request(id, url, std::move(post_data), std::move(body), opts, std::move(timeline));
+        if (opts.polling_streaming) {
+            streaming_count.fetch_add(1, std::memory_order_acq_rel);
+        }
+
+        // return empty resource
+        return polling_resource(id, opts, url);
+    }
+
+    resource submit(const std::string& url, std::unique_ptr<std::istream> post_data,
+            request_body body, request_options opts) {
+        if ("" == opts.method) {
+            opts.method = "POST";
+        }
+        auto id = increment_resource_id();
+        auto timeline = request_timeline(opts.record_timeline);
+        timeline.mark_submitted();
+        auto res = polling_resource(id, opts, url);
+        if (opts.polling_streaming) {
+            streaming_count.fetch_add(1, std::memory_order_acq_rel);
+        }
+        submissions_count.fetch_add(1, std::memory_order_acq_rel);
+        submissions.push(submission{id, url, std::move(post_data), std::move(body), std::move(opts),
+                std::move(timeline)});
+        wakeup_quietly();
+        return std::move(res);
+    }
+
+    void add_submissions(std::vector<resource>& results) {
+        if (0 == submissions_count.load(std::memory_order_acquire)) {
+            return;
+        }
+        submissions.drain([this, &results](submission&& sub) {
+            submissions_count.fetch_sub(1, std::memory_order_acq_rel);
+            sub.timeline.mark_dequeued();
+            try {
+                add_request(sub.id, sub.url, std::move(sub.post_data), std::move(sub.body), sub.options,
+                        sub.timeline);
+            } catch (const std::exception& e) {
+                if (sub.options.polling_streaming) {
+                    streaming_count.fetch_sub(1, std::memory_order_acq_rel);
+                }
+                // reported as a failed request, submitter cannot catch it
+                auto err = std::string("Error reported for request, url: [") + sub.url + "]\n" + e.what();
+                results.emplace_back(polling_resource(sub.id, sub.options, sub.url, curl_info_snapshot(),
+                        sub.timeline.get(), 0, std::vector<std::pair<std::string, std::string>>(),
+                        response_body_buffer(), err));
+            }
+        });
+    }
+
+    void wakeup_quietly() STATICLIB_NOEXCEPT {
+        try {
+            wakeup_internal();
+        } catch (const std::exception& e) {
+            // request is picked up on the next round anyway
+            (void) e;
+        }
+    }
+
+    void add_request(uint64_t id, const std::string& url, std::unique_ptr<std::istream> post_data,
+            request_body body, const request_options& opts, request_timeline timeline) {
+
+        if (queue.size() >= options.requests_queue_max_size) throw http_exception(TRACEMSG(
+                "HTTP queue max size exceeded, url: [" + url + "]" +
+                " queue size: [" + sl::support::to_string(queue.size()) + "]"));
+
+        // create easy handle
+        auto easy_handle = std::unique_ptr<CURL, curl_easy_deleter>(
+                curl_easy_init(), curl_easy_deleter(this->handle.get()));
+        if (nullptr == easy_handle.get()) throw http_exception(TRACEMSG(
+                "Error creating cURL handle, url: [" + url + "]," +
+                " queue size: [" + sl::support::to_string(queue.size()) + "]"));
+
+        // enqueue request
+        CURLMcode errm = curl_multi_add_handle(handle.get(), easy_handle.get());
+        if (errm != CURLM_OK) throw http_exception(TRACEMSG(
+                "cURL multi_add error: [" + curl_multi_strerror(errm) + "], url: [" + url + "]"));
+
+        auto key = reinterpret_cast<int64_t>(easy_handle.get());
+        auto req = sl::support::make_unique<request>(id, std::move(easy_handle), url, std::move(post_data),
+                std::move(body), opts, std::move(timeline), headers_cache, file_writer.get(), block_pool);
+        auto inserted = queue.insert(std::make_pair(key, std::move(req)));
+        if (!inserted.second) throw http_exception(TRACEMSG(
+                "Error enqueuing cURL handle, url: [" + url + "]," +
+                " queue size: [" + sl::support::to_string(queue.size()) + "]"));
+        metrics.on_submitted(false);
+    }
+
     std::unique_ptr<request> dequeue_request(int64_t key) {
         auto it = queue.find(key);
         if (queue.end() == it) throw http_exception(TRACEMSG(
@@ -300,7 +875,14 @@ public:
 };
 PIMPL_FORWARD_CONSTRUCTOR(polling_session, (session_options), (), http_exception)
 PIMPL_FORWARD_METHOD(polling_session, resource, open_url, (const std::string&)(std::unique_ptr<std::istream>)(request_options), (), http_exception)
+PIMPL_FORWARD_METHOD(polling_session, resource, open_url, (const std::string&)(request_body)(request_options), (), http_exception)
 PIMPL_FORWARD_METHOD(polling_session, std::vector<resource>, poll, (), (), http_exception)
+PIMPL_FORWARD_METHOD(polling_session, std::vector<resource>, poll, (std::vector<polling_event>&), (), http_exception)
+PIMPL_FORWARD_METHOD(polling_session, size_t, poll, (uint32_t)(size_t)(std::vector<resource>&), (), http_exception)
+PIMPL_FORWARD_METHOD(polling_session, size_t, poll, (uint32_t)(size_t)(std::vector<resource>&)(std::vector<polling_event>&), (), http_exception)
+PIMPL_FORWARD_METHOD(polling_session, resource, submit_url, (const std::string&)(request_options), (), http_exception)
+PIMPL_FORWARD_METHOD(polling_session, resource, submit_url, (const std::string&)(request_body)(request_options), (), http_exception)
+PIMPL_FORWARD_METHOD(polling_session, void, wakeup, (), (), http_exception)
 PIMPL_FORWARD_METHOD(polling_session, size_t, enqueued_requests_count, (), (), http_exception)
 
 } // namespace
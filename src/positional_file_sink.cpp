@@ -0,0 +1,188 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   positional_file_sink.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 11:35 PM
+ */
+
+#include "positional_file_sink.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+
+#ifdef STATICLIB_WINDOWS
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif // NOMINMAX
+#include <windows.h>
+#else // !STATICLIB_WINDOWS
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif // STATICLIB_WINDOWS
+
+#include "staticlib/support.hpp"
+
+namespace staticlib {
+namespace http {
+
+#ifdef STATICLIB_WINDOWS
+
+positional_file_sink::positional_file_sink(const std::string& path, uint64_t offset) :
+handle(reinterpret_cast<intptr_t> (INVALID_HANDLE_VALUE)),
+offset(offset),
+path(path.data(), path.length()) {
+    HANDLE ha = ::CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (INVALID_HANDLE_VALUE == ha) throw http_exception(TRACEMSG(
+            "Error opening file for writing, path: [" + path + "]," +
+            " error: [" + sl::support::to_string(::GetLastError()) + "]"));
+    this->handle = reinterpret_cast<intptr_t> (ha);
+}
+
+positional_file_sink::~positional_file_sink() STATICLIB_NOEXCEPT {
+    ::CloseHandle(reinterpret_cast<HANDLE> (handle));
+}
+
+std::streamsize positional_file_sink::write_at(sl::io::span<const char> span, uint64_t offset) {
+    size_t written = 0;
+    while (written < span.size()) {
+        auto chunk = static_cast<DWORD> (std::min(span.size() - written,
+                static_cast<size_t> (std::numeric_limits<DWORD>::max())));
+        OVERLAPPED ov;
+        std::memset(std::addressof(ov), '\0', sizeof(ov));
+        ov.Offset = static_cast<DWORD> (offset & 0xffffffff);
+        ov.OffsetHigh = static_cast<DWORD> (offset >> 32);
+        DWORD res = 0;
+        auto success = ::WriteFile(reinterpret_cast<HANDLE> (handle), span.data() + written,
+                chunk, std::addressof(res), std::addressof(ov));
+        if (0 == success) throw http_exception(TRACEMSG(
+                "Error writing file, path: [" + path + "]," +
+                " offset: [" + sl::support::to_string(offset) + "]," +
+                " error: [" + sl::support::to_string(::GetLastError()) + "]"));
+        written += res;
+        offset += res;
+    }
+    return static_cast<std::streamsize> (written);
+}
+
+void positional_file_sink::sync() {
+    if (0 == ::FlushFileBuffers(reinterpret_cast<HANDLE> (handle))) throw http_exception(TRACEMSG(
+            "Error flushing file, path: [" + path + "]," +
+            " error: [" + sl::support::to_string(::GetLastError()) + "]"));
+}
+
+void preallocate_file(const std::string& path, uint64_t size) {
+    HANDLE ha = ::CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+            CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (INVALID_HANDLE_VALUE == ha) throw http_exception(TRACEMSG(
+            "Error creating file, path: [" + path + "]," +
+            " error: [" + sl::support::to_string(::GetLastError()) + "]"));
+    LARGE_INTEGER pos;
+    pos.QuadPart = static_cast<LONGLONG> (size);
+    auto success = ::SetFilePointerEx(ha, pos, NULL, FILE_BEGIN) && ::SetEndOfFile(ha);
+    auto err = ::GetLastError();
+    ::CloseHandle(ha);
+    if (!success) throw http_exception(TRACEMSG(
+            "Error preallocating file, path: [" + path + "]," +
+            " size: [" + sl::support::to_string(size) + "]," +
+            " error: [" + sl::support::to_string(err) + "]"));
+}
+
+#else // !STATICLIB_WINDOWS
+
+positional_file_sink::positional_file_sink(const std::string& path, uint64_t offset) :
+handle(-1),
+offset(offset),
+path(path.data(), path.length()) {
+    int fd = ::open(path.c_str(), O_WRONLY);
+    if (-1 == fd) throw http_exception(TRACEMSG(
+            "Error opening file for writing, path: [" + path + "]," +
+            " error: [" + ::strerror(errno) + "]"));
+    this->handle = static_cast<intptr_t> (fd);
+}
+
+positional_file_sink::~positional_file_sink() STATICLIB_NOEXCEPT {
+    ::close(static_cast<int> (handle));
+}
+
+std::streamsize positional_file_sink::write_at(sl::io::span<const char> span, uint64_t offset) {
+    size_t written = 0;
+    while (written < span.size()) {
+        auto res = ::pwrite(static_cast<int> (handle), span.data() + written,
+                span.size() - written, static_cast<off_t> (offset));
+        if (-1 == res) {
+            if (EINTR == errno) continue;
+            throw http_exception(TRACEMSG("Error writing file, path: [" + path + "]," +
+                    " offset: [" + sl::support::to_string(offset) + "]," +
+                    " error: [" + ::strerror(errno) + "]"));
+        }
+        written += static_cast<size_t> (res);
+        offset += static_cast<uint64_t> (res);
+    }
+    return static_cast<std::streamsize> (written);
+}
+
+void positional_file_sink::sync() {
+#ifdef STATICLIB_MAC
+    int res = ::fsync(static_cast<int> (handle));
+#else // !STATICLIB_MAC
+    int res = ::fdatasync(static_cast<int> (handle));
+#endif // STATICLIB_MAC
+    if (-1 == res) throw http_exception(TRACEMSG(
+            "Error flushing file, path: [" + path + "]," +
+            " error: [" + ::strerror(errno) + "]"));
+}
+
+void preallocate_file(const std::string& path, uint64_t size) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (-1 == fd) throw http_exception(TRACEMSG(
+            "Error creating file, path: [" + path + "]," +
+            " error: [" + ::strerror(errno) + "]"));
+    int err = 0;
+    if (size > 0) {
+#ifndef STATICLIB_MAC
+        // reserves blocks, so segments written out of order do not fragment the file
+        err = ::posix_fallocate(fd, 0, static_cast<off_t> (size));
+        if (EINVAL == err || EOPNOTSUPP == err) {
+            err = -1 == ::ftruncate(fd, static_cast<off_t> (size)) ? errno : 0;
+        }
+#else // STATICLIB_MAC
+        err = -1 == ::ftruncate(fd, static_cast<off_t> (size)) ? errno : 0;
+#endif // STATICLIB_MAC
+    }
+    ::close(fd);
+    if (0 != err) throw http_exception(TRACEMSG(
+            "Error preallocating file, path: [" + path + "]," +
+            " size: [" + sl::support::to_string(size) + "]," +
+            " error: [" + ::strerror(err) + "]"));
+}
+
+#endif // STATICLIB_WINDOWS
+
+std::streamsize positional_file_sink::write(sl::io::span<const char> span) {
+    auto written = write_at(span, offset);
+    offset += static_cast<uint64_t> (written);
+    return written;
+}
+
+} // namespace
+}
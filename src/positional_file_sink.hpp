@@ -0,0 +1,79 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   positional_file_sink.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 11:30 PM
+ */
+
+#ifndef STATICLIB_HTTP_POSITIONAL_FILE_SINK_HPP
+#define STATICLIB_HTTP_POSITIONAL_FILE_SINK_HPP
+
+#include <cstdint>
+#include <ios>
+#include <string>
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+
+#include "staticlib/http/http_exception.hpp"
+
+namespace staticlib {
+namespace http {
+
+// writes into the existing file starting at the specified offset,
+// file is not truncated, multiple sinks may write disjoint ranges
+// of the same file concurrently
+class positional_file_sink {
+    // fd or HANDLE
+    intptr_t handle;
+    uint64_t offset;
+    std::string path;
+
+public:
+    positional_file_sink(const std::string& path, uint64_t offset);
+
+    ~positional_file_sink() STATICLIB_NOEXCEPT;
+
+    positional_file_sink(const positional_file_sink&) = delete;
+
+    positional_file_sink& operator=(const positional_file_sink&) = delete;
+
+    std::streamsize write(sl::io::span<const char> span);
+
+    std::streamsize flush() {
+        return 0;
+    }
+
+    // does not change the sink offset, can be called
+    // concurrently for disjoint ranges
+    std::streamsize write_at(sl::io::span<const char> span, uint64_t offset);
+
+    // flushes written data to disk
+    void sync();
+};
+
+// creates (or truncates) the file and reserves the specified
+// size on disk, file is filled with zeros
+void preallocate_file(const std::string& path, uint64_t size);
+
+} // namespace
+}
+
+#endif /* STATICLIB_HTTP_POSITIONAL_FILE_SINK_HPP */
+
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   request_body_reader.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 9:20 PM
+ */
+
+#ifndef STATICLIB_HTTP_REQUEST_BODY_READER_HPP
+#define STATICLIB_HTTP_REQUEST_BODY_READER_HPP
+
+#include <cstdint>
+#include <cstring>
+
+#include "staticlib/http/request_body.hpp"
+
+namespace staticlib {
+namespace http {
+
+// per-request read position over the shared body, used only
+// when the body cannot be passed to cURL in place
+class request_body_reader {
+    request_body body;
+    size_t segment_idx = 0;
+    size_t segment_offset = 0;
+
+public:
+    request_body_reader() { }
+
+    request_body_reader(request_body body) :
+    body(std::move(body)) { }
+
+    const request_body& get_body() const {
+        return body;
+    }
+
+    // cURL can use the body memory directly
+    bool is_contiguous() const {
+        return body.get_segments().size() <= 1;
+    }
+
+    size_t read(char* buffer, size_t len) {
+        auto& segments = body.get_segments();
+        size_t written = 0;
+        while (written < len && segment_idx < segments.size()) {
+            auto& seg = segments[segment_idx];
+            size_t avail = seg.size() - segment_offset;
+            size_t chunk = avail <= len - written ? avail : len - written;
+            std::memcpy(buffer + written, seg.data() + segment_offset, chunk);
+            written += chunk;
+            segment_offset += chunk;
+            if (segment_offset == seg.size()) {
+                segment_idx += 1;
+                segment_offset = 0;
+            }
+        }
+        return written;
+    }
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_HTTP_REQUEST_BODY_READER_HPP */
+
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   request_resubmitter.hpp
+ * Author: alex
+ *
+ * Created on October 19, 2026, 12:20 AM
+ */
+
+#ifndef STATICLIB_HTTP_REQUEST_RESUBMITTER_HPP
+#define STATICLIB_HTTP_REQUEST_RESUBMITTER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "staticlib/http/http_exception.hpp"
+#include "staticlib/http/request_options.hpp"
+
+#include "running_request_pipe.hpp"
+
+namespace staticlib {
+namespace http {
+
+// shared between session and its resources, lets resources re-issue
+// requests, session detaches itself on destruction
+class request_resubmitter {
+public:
+    using submit_type = std::function<std::shared_ptr<running_request_pipe>(
+            uint64_t, const std::string&, request_options)>;
+
+private:
+    std::mutex mutex;
+    submit_type submit_fun;
+
+public:
+    request_resubmitter(submit_type submit_fun) :
+    submit_fun(std::move(submit_fun)) { }
+
+    request_resubmitter(const request_resubmitter&) = delete;
+
+    request_resubmitter& operator=(const request_resubmitter&) = delete;
+
+    bool is_attached() {
+        std::lock_guard<std::mutex> guard{mutex};
+        return static_cast<bool> (submit_fun);
+    }
+
+    std::shared_ptr<running_request_pipe> resubmit(uint64_t id, const std::string& url,
+            request_options options) {
+        std::lock_guard<std::mutex> guard{mutex};
+        if (!submit_fun) throw http_exception(TRACEMSG(
+                "Cannot re-issue request, session is already destroyed, url: [" + url + "]"));
+        return submit_fun(id, url, std::move(options));
+    }
+
+    void detach() STATICLIB_NOEXCEPT {
+        std::lock_guard<std::mutex> guard{mutex};
+        submit_fun = nullptr;
+    }
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_HTTP_REQUEST_RESUBMITTER_HPP */
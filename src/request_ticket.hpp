@@ -24,41 +24,73 @@
 #ifndef STATICLIB_HTTP_REQUEST_TICKET_HPP
 #define STATICLIB_HTTP_REQUEST_TICKET_HPP
 
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+
+#include "staticlib/http/request_body.hpp"
+#include "staticlib/http/request_options.hpp"
+
+#include "request_timeline.hpp"
+#include "running_request_pipe.hpp"
+#include "upload_pipe.hpp"
+
 namespace staticlib {
 namespace http {
 
 class request_ticket {
 public:
+    uint64_t id = 0;
     std::string url;
     request_options options;
     std::unique_ptr<std::istream> post_data;
+    request_body body;
+    std::shared_ptr<upload_pipe> upload;
     std::shared_ptr<running_request_pipe> pipe;
+    request_timeline timeline;
 
     request_ticket() { }
 
-    request_ticket(const std::string& url, const request_options& options,
-            std::unique_ptr<std::istream>&& post_data,
+    // only one of post_data, body and upload is expected to be set
+    request_ticket(uint64_t id, const std::string& url, const request_options& options,
+            std::unique_ptr<std::istream>&& post_data, request_body&& body,
+            std::shared_ptr<upload_pipe>&& upload,
             std::shared_ptr<running_request_pipe> pipe) :
+    id(id),
     url(url.data(), url.length()),
     options(options),
     post_data(std::move(post_data)),
-    pipe(std::move(pipe)) { }
+    body(std::move(body)),
+    upload(std::move(upload)),
+    pipe(std::move(pipe)),
+    timeline(options.record_timeline) {
+        timeline.mark_submitted();
+    }
 
     request_ticket(const request_ticket&) = delete;
 
     request_ticket& operator=(const request_ticket&) = delete;
 
     request_ticket(request_ticket&& other) :
+    id(other.id),
     url(std::move(other.url)),
     options(std::move(other.options)),
     post_data(std::move(other.post_data)),
-    pipe(std::move(other.pipe)) { }
+    body(std::move(other.body)),
+    upload(std::move(other.upload)),
+    pipe(std::move(other.pipe)),
+    timeline(std::move(other.timeline)) { }
 
     request_ticket& operator=(request_ticket&& other) {
+        id = other.id;
         url = std::move(other.url);
         options = std::move(other.options);
         post_data = std::move(other.post_data);
+        body = std::move(other.body);
+        upload = std::move(other.upload);
         pipe = std::move(other.pipe);
+        timeline = std::move(other.timeline);
         return *this;
     }
 
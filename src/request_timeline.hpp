@@ -0,0 +1,108 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   request_timeline.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 2:31 PM
+ */
+
+#ifndef STATICLIB_HTTP_REQUEST_TIMELINE_HPP
+#define STATICLIB_HTTP_REQUEST_TIMELINE_HPP
+
+#include <cstdint>
+#include <chrono>
+
+#include "staticlib/http/resource_timeline.hpp"
+
+namespace staticlib {
+namespace http {
+
+inline int64_t timeline_now() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<int64_t> (std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+// every mark is a single branch when disabled,
+// not thread-safe, owner is responsible for publishing
+class request_timeline {
+    bool enabled;
+    resource_timeline timeline;
+
+public:
+    request_timeline(bool enabled = false) :
+    enabled(enabled) { }
+
+    bool is_enabled() const {
+        return enabled;
+    }
+
+    void mark_submitted() {
+        if (!enabled) return;
+        timeline.submitted = timeline_now();
+    }
+
+    void mark_dequeued() {
+        if (!enabled) return;
+        timeline.dequeued = timeline_now();
+    }
+
+    void mark_multi_added() {
+        if (!enabled) return;
+        timeline.multi_added = timeline_now();
+    }
+
+    void mark_first_header() {
+        if (!enabled || -1 != timeline.first_header) return;
+        timeline.first_header = timeline_now();
+    }
+
+    void mark_first_byte() {
+        if (!enabled || -1 != timeline.first_byte) return;
+        timeline.first_byte = timeline_now();
+    }
+
+    void mark_paused() {
+        if (!enabled) return;
+        timeline.pauses.emplace_back(timeline_now(), -1);
+    }
+
+    void mark_unpaused() {
+        if (!enabled || timeline.pauses.empty()) return;
+        timeline.pauses.back().second = timeline_now();
+    }
+
+    void mark_completed() {
+        if (!enabled) return;
+        timeline.completed = timeline_now();
+    }
+
+    void mark_consumer_eof() {
+        if (!enabled || -1 != timeline.consumer_eof) return;
+        timeline.consumer_eof = timeline_now();
+    }
+
+    const resource_timeline& get() const {
+        return timeline;
+    }
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_HTTP_REQUEST_TIMELINE_HPP */
+
@@ -38,12 +38,15 @@ PIMPL_FORWARD_METHOD(resource, std::streamsize, read, (sl::io::span<char>), (),
 PIMPL_FORWARD_METHOD(resource, const std::string&, get_url, (), (const), http_exception)
 PIMPL_FORWARD_METHOD(resource, uint16_t, get_status_code, (), (const), http_exception)
 PIMPL_FORWARD_METHOD(resource, resource_info, get_info, (), (const), http_exception)
+PIMPL_FORWARD_METHOD(resource, resource_timeline, get_timeline, (), (const), http_exception)
 PIMPL_FORWARD_METHOD(resource, headers_type, get_headers, (), (const), http_exception)
 PIMPL_FORWARD_METHOD(resource, const std::string&, get_header, (const std::string&), (const), http_exception)
 PIMPL_FORWARD_METHOD(resource, bool, connection_successful, (), (const), http_exception)
 PIMPL_FORWARD_METHOD(resource, uint64_t, get_id, (), (const), http_exception)
 PIMPL_FORWARD_METHOD(resource, const request_options&, get_request_options, (), (const), http_exception)
 PIMPL_FORWARD_METHOD(resource, const std::string&, get_error, (), (const), http_exception)
+PIMPL_FORWARD_METHOD(resource, sl::io::span<const char>, body_view, (), (), http_exception)
+PIMPL_FORWARD_METHOD(resource, std::vector<char>, take_body, (), (), http_exception)
 
 } // namespace
 }
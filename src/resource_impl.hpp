@@ -26,6 +26,11 @@
 
 #include "staticlib/http/resource.hpp"
 
+#include <string>
+#include <vector>
+
+#include "staticlib/http/http_exception.hpp"
+
 #include "staticlib/http/request_options.hpp"
 
 namespace staticlib {
@@ -42,6 +47,8 @@ public:
 
     virtual resource_info get_info(const resource&) const = 0;
 
+    virtual resource_timeline get_timeline(const resource&) const = 0;
+
     virtual const std::vector<std::pair<std::string, std::string>>& get_headers(const resource&) const = 0;
 
     virtual const std::string& get_header(const resource&,const std::string& name) const = 0;
@@ -53,6 +60,17 @@ public:
     virtual const request_options& get_request_options(const resource&) const = 0;
 
     virtual const std::string& get_error(const resource&) const = 0;
+
+    // buffered bodies are supported only by polling resources
+    virtual sl::io::span<const char> body_view(resource& frontend) {
+        throw http_exception(TRACEMSG("Body view is not supported for this resource," +
+                " url: [" + get_url(frontend) + "]"));
+    }
+
+    virtual std::vector<char> take_body(resource& frontend) {
+        throw http_exception(TRACEMSG("Taking body is not supported for this resource," +
+                " url: [" + get_url(frontend) + "]"));
+    }
 };
 
 } // namespace
@@ -27,6 +27,7 @@
 #include <string>
 #include <memory>
 
+#include "request_resubmitter.hpp"
 #include "running_request_pipe.hpp"
 
 namespace staticlib {
@@ -36,10 +37,13 @@ class resource_params {
 public:
     const std::string& url;
     std::shared_ptr<running_request_pipe> pipe;
+    std::shared_ptr<request_resubmitter> resubmitter;
 
-    resource_params(const std::string& url, std::shared_ptr<running_request_pipe>&& pipe) :
+    resource_params(const std::string& url, std::shared_ptr<running_request_pipe>&& pipe,
+            std::shared_ptr<request_resubmitter> resubmitter = std::shared_ptr<request_resubmitter>()) :
     url(url),
-    pipe(std::move(pipe)) { }
+    pipe(std::move(pipe)),
+    resubmitter(std::move(resubmitter)) { }
 
     resource_params(const resource_params&) = delete;
 
@@ -47,7 +51,8 @@ public:
 
     resource_params(resource_params&& other) :
     url(other.url),
-    pipe(std::move(other.pipe)) { }
+    pipe(std::move(other.pipe)),
+    resubmitter(std::move(other.resubmitter)) { }
 
     resource_params& operator=(resource_params&&) = delete;
 
@@ -0,0 +1,373 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   response_body_buffer.cpp
+ * Author: alex
+ *
+ * Created on October 19, 2026, 2:45 AM
+ */
+
+#include "response_body_buffer.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+
+#ifdef STATICLIB_WINDOWS
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif // NOMINMAX
+#include <windows.h>
+#else // !STATICLIB_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif // STATICLIB_WINDOWS
+
+#include "staticlib/support.hpp"
+
+namespace staticlib {
+namespace http {
+
+namespace { // anonymous
+
+size_t checked_length(uint64_t size) {
+    if (size > static_cast<uint64_t> (std::numeric_limits<size_t>::max())) throw http_exception(TRACEMSG(
+            "Response body is too large to be mapped on this platform, size: [" + sl::support::to_string(size) + "]"));
+    return static_cast<size_t> (size);
+}
+
+} // namespace
+
+#ifdef STATICLIB_WINDOWS
+
+response_body_buffer::response_body_buffer(std::shared_ptr<body_block_pool> pool, uint64_t spill_threshold,
+        const std::string& spill_dir) :
+pool(std::move(pool)),
+spill_threshold(spill_threshold),
+spill_dir(spill_dir.data(), spill_dir.length()),
+handle(reinterpret_cast<intptr_t> (INVALID_HANDLE_VALUE)) { }
+
+void response_body_buffer::spill() {
+    auto dir = spill_dir;
+    if (dir.empty()) {
+        auto tmp = std::string();
+        tmp.resize(MAX_PATH + 1);
+        auto len = ::GetTempPathA(static_cast<DWORD> (tmp.size()), std::addressof(tmp.front()));
+        if (0 == len || len > tmp.size()) throw http_exception(TRACEMSG(
+                "Error getting temporary directory, error: [" + sl::support::to_string(::GetLastError()) + "]"));
+        dir = tmp.substr(0, len);
+    }
+    auto name = std::string();
+    name.resize(MAX_PATH + 1);
+    if (0 == ::GetTempFileNameA(dir.c_str(), "slh", 0, std::addressof(name.front()))) throw http_exception(TRACEMSG(
+            "Error creating temporary file, directory: [" + dir + "]," +
+            " error: [" + sl::support::to_string(::GetLastError()) + "]"));
+    // file is deleted when the last handle (or mapping) is closed
+    HANDLE ha = ::CreateFileA(name.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+            FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (INVALID_HANDLE_VALUE == ha) {
+        auto err = ::GetLastError();
+        ::DeleteFileA(name.c_str());
+        throw http_exception(TRACEMSG("Error opening temporary file, path: [" + name + "]," +
+                " error: [" + sl::support::to_string(err) + "]"));
+    }
+    this->handle = reinterpret_cast<intptr_t> (ha);
+}
+
+void response_body_buffer::write_file(const char* data, size_t len) {
+    size_t written = 0;
+    while (written < len) {
+        auto chunk = static_cast<DWORD> (std::min(len - written,
+                static_cast<size_t> (std::numeric_limits<DWORD>::max())));
+        DWORD res = 0;
+        if (0 == ::WriteFile(reinterpret_cast<HANDLE> (handle), data + written, chunk,
+                std::addressof(res), NULL)) throw http_exception(TRACEMSG(
+                "Error writing temporary file, size: [" + sl::support::to_string(total) + "]," +
+                " error: [" + sl::support::to_string(::GetLastError()) + "]"));
+        written += res;
+    }
+}
+
+void response_body_buffer::finish() {
+    if (!spilled || nullptr != mapped) return;
+    this->mapped_length = checked_length(total);
+    HANDLE mp = ::CreateFileMappingA(reinterpret_cast<HANDLE> (handle), NULL, PAGE_READONLY, 0, 0, NULL);
+    auto err = ::GetLastError();
+    // mapping keeps the file alive
+    close_file();
+    if (NULL == mp) throw http_exception(TRACEMSG(
+            "Error mapping temporary file, error: [" + sl::support::to_string(err) + "]"));
+    this->mapping = reinterpret_cast<intptr_t> (mp);
+    this->mapped = static_cast<const char*> (::MapViewOfFile(mp, FILE_MAP_READ, 0, 0, 0));
+    if (nullptr == mapped) throw http_exception(TRACEMSG(
+            "Error mapping temporary file view, error: [" + sl::support::to_string(::GetLastError()) + "]"));
+}
+
+void response_body_buffer::close_file() STATICLIB_NOEXCEPT {
+    auto ha = reinterpret_cast<HANDLE> (handle);
+    if (INVALID_HANDLE_VALUE != ha) {
+        ::CloseHandle(ha);
+        this->handle = reinterpret_cast<intptr_t> (INVALID_HANDLE_VALUE);
+    }
+}
+
+response_body_buffer::~response_body_buffer() STATICLIB_NOEXCEPT {
+    release_blocks();
+    if (nullptr != mapped) {
+        ::UnmapViewOfFile(mapped);
+    }
+    if (0 != mapping) {
+        ::CloseHandle(reinterpret_cast<HANDLE> (mapping));
+    }
+    close_file();
+}
+
+#else // !STATICLIB_WINDOWS
+
+response_body_buffer::response_body_buffer(std::shared_ptr<body_block_pool> pool, uint64_t spill_threshold,
+        const std::string& spill_dir) :
+pool(std::move(pool)),
+spill_threshold(spill_threshold),
+spill_dir(spill_dir.data(), spill_dir.length()),
+handle(-1) { }
+
+void response_body_buffer::spill() {
+    auto dir = spill_dir;
+    if (dir.empty()) {
+        auto env = std::getenv("TMPDIR");
+        dir = nullptr != env && '\0' != env[0] ? std::string(env) : std::string("/tmp");
+    }
+    int fd = -1;
+#ifdef O_TMPFILE
+    // unnamed file, never visible in the directory
+    fd = ::open(dir.c_str(), O_TMPFILE | O_RDWR, 0600);
+#endif // O_TMPFILE
+    if (-1 == fd) {
+        auto name = dir + "/staticlib_http_XXXXXX";
+        fd = ::mkstemp(std::addressof(name.front()));
+        if (-1 != fd) {
+            ::unlink(name.c_str());
+        }
+    }
+    if (-1 == fd) throw http_exception(TRACEMSG(
+            "Error creating temporary file, directory: [" + dir + "]," +
+            " error: [" + ::strerror(errno) + "]"));
+    this->handle = static_cast<intptr_t> (fd);
+}
+
+void response_body_buffer::write_file(const char* data, size_t len) {
+    size_t written = 0;
+    while (written < len) {
+        auto res = ::write(static_cast<int> (handle), data + written, len - written);
+        if (-1 == res) {
+            if (EINTR == errno) continue;
+            throw http_exception(TRACEMSG("Error writing temporary file," +
+                    " size: [" + sl::support::to_string(total) + "]," +
+                    " error: [" + ::strerror(errno) + "]"));
+        }
+        written += static_cast<size_t> (res);
+    }
+}
+
+void response_body_buffer::finish() {
+    if (!spilled || nullptr != mapped) return;
+    this->mapped_length = checked_length(total);
+    void* res = ::mmap(nullptr, mapped_length, PROT_READ, MAP_PRIVATE, static_cast<int> (handle), 0);
+    auto err = errno;
+    // mapping stays valid after close, file is freed on unmap
+    close_file();
+    if (MAP_FAILED == res) throw http_exception(TRACEMSG(
+            "Error mapping temporary file, size: [" + sl::support::to_string(total) + "]," +
+            " error: [" + ::strerror(err) + "]"));
+    // hint only, failure is not an error
+    ::madvise(res, mapped_length, MADV_SEQUENTIAL);
+    this->mapped = static_cast<const char*> (res);
+}
+
+void response_body_buffer::close_file() STATICLIB_NOEXCEPT {
+    if (-1 != handle) {
+        ::close(static_cast<int> (handle));
+        this->handle = -1;
+    }
+}
+
+response_body_buffer::~response_body_buffer() STATICLIB_NOEXCEPT {
+    release_blocks();
+    if (nullptr != mapped) {
+        ::munmap(const_cast<char*> (mapped), mapped_length);
+    }
+    close_file();
+}
+
+#endif // STATICLIB_WINDOWS
+
+const size_t body_block_pool::block_size;
+
+response_body_buffer::response_body_buffer(response_body_buffer&& other) :
+pool(std::move(other.pool)),
+mem(std::move(other.mem)),
+blocks(std::move(other.blocks)),
+total(other.total),
+spill_threshold(other.spill_threshold),
+spill_dir(std::move(other.spill_dir)),
+handle(other.handle),
+spilled(other.spilled),
+mapped(other.mapped),
+mapped_length(other.mapped_length) {
+#ifdef STATICLIB_WINDOWS
+    this->mapping = other.mapping;
+    other.mapping = 0;
+    other.handle = reinterpret_cast<intptr_t> (INVALID_HANDLE_VALUE);
+#else // !STATICLIB_WINDOWS
+    other.handle = -1;
+#endif // STATICLIB_WINDOWS
+    other.blocks.clear();
+    other.total = 0;
+    other.spilled = false;
+    other.mapped = nullptr;
+    other.mapped_length = 0;
+}
+
+void response_body_buffer::reserve(uint64_t size) {
+    if (total > 0 || spilled) return;
+    if (spill_threshold > 0 && size > spill_threshold) {
+        // goes to disk anyway
+        spill();
+        this->spilled = true;
+        return;
+    }
+    mem.reserve(checked_length(size));
+}
+
+void response_body_buffer::append(const char* data, size_t len) {
+    if (spilled) {
+        write_file(data, len);
+        total += len;
+        return;
+    }
+    if (spill_threshold > 0 && total + len > spill_threshold) {
+        spill();
+        this->spilled = true;
+        write_file(mem.data(), mem.size());
+        // releases memory
+        std::vector<char>().swap(mem);
+        uint64_t left = total;
+        for (char* bl : blocks) {
+            size_t bl_len = static_cast<size_t> (std::min(left, static_cast<uint64_t> (body_block_pool::block_size)));
+            write_file(bl, bl_len);
+            left -= bl_len;
+        }
+        release_blocks();
+        write_file(data, len);
+        total += len;
+        return;
+    }
+    if (mem.capacity() > 0) {
+        // size is known in advance
+        mem.insert(mem.end(), data, data + len);
+    } else {
+        append_blocks(data, len);
+    }
+    total += len;
+}
+
+void response_body_buffer::append_blocks(const char* data, size_t len) {
+    size_t bsize = body_block_pool::block_size;
+    size_t used = blocks.empty() ? 0 : static_cast<size_t> (total - (blocks.size() - 1) * bsize);
+    size_t copied = 0;
+    while (copied < len) {
+        if (blocks.empty() || bsize == used) {
+            blocks.push_back(nullptr != pool.get() ? pool->take() : new char[bsize]);
+            used = 0;
+        }
+        size_t chunk = std::min(len - copied, bsize - used);
+        std::memcpy(blocks.back() + used, data + copied, chunk);
+        used += chunk;
+        copied += chunk;
+    }
+}
+
+void response_body_buffer::release_blocks() STATICLIB_NOEXCEPT {
+    for (char* bl : blocks) {
+        if (nullptr != pool.get()) {
+            pool->give_back(bl);
+        } else {
+            delete[] bl;
+        }
+    }
+    blocks.clear();
+}
+
+size_t response_body_buffer::read_at(uint64_t offset, sl::io::span<char> dest) const {
+    if (offset >= total) return 0;
+    size_t len = static_cast<size_t> (std::min(static_cast<uint64_t> (dest.size()), total - offset));
+    if (spilled) {
+        if (nullptr == mapped) return 0;
+        std::memcpy(dest.data(), mapped + offset, len);
+        return len;
+    }
+    if (blocks.empty()) {
+        std::memcpy(dest.data(), mem.data() + offset, len);
+        return len;
+    }
+    size_t bsize = body_block_pool::block_size;
+    size_t copied = 0;
+    while (copied < len) {
+        uint64_t pos = offset + copied;
+        size_t idx = static_cast<size_t> (pos / bsize);
+        size_t in_block = static_cast<size_t> (pos % bsize);
+        size_t chunk = std::min(len - copied, bsize - in_block);
+        std::memcpy(dest.data() + copied, blocks[idx] + in_block, chunk);
+        copied += chunk;
+    }
+    return len;
+}
+
+std::vector<char> response_body_buffer::take() {
+    auto res = std::vector<char>();
+    if (spilled) {
+        // mapping is released with this buffer
+        res.resize(checked_length(total));
+        read_at(0, {res.data(), res.size()});
+    } else {
+        flatten();
+        res.swap(mem);
+    }
+    this->total = 0;
+    return res;
+}
+
+sl::io::span<const char> response_body_buffer::flatten() {
+    if (spilled) {
+        return sl::io::span<const char>(mapped, nullptr != mapped ? static_cast<size_t> (total) : 0);
+    }
+    if (!blocks.empty()) {
+        auto flat = std::vector<char>();
+        flat.resize(checked_length(total));
+        read_at(0, {flat.data(), flat.size()});
+        release_blocks();
+        this->mem = std::move(flat);
+    }
+    return sl::io::span<const char>(mem.data(), mem.size());
+}
+
+} // namespace
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   response_body_buffer.hpp
+ * Author: alex
+ *
+ * Created on October 19, 2026, 2:30 AM
+ */
+
+#ifndef STATICLIB_HTTP_RESPONSE_BODY_BUFFER_HPP
+#define STATICLIB_HTTP_RESPONSE_BODY_BUFFER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+
+#include "staticlib/http/http_exception.hpp"
+
+namespace staticlib {
+namespace http {
+
+// reusable fixed-size blocks for response bodies of unknown size,
+// shared between session and resources that may outlive it
+class body_block_pool {
+    std::mutex mutex;
+    std::vector<char*> free_blocks;
+    size_t max_free_blocks;
+
+public:
+    static const size_t block_size = 64 * 1024;
+
+    body_block_pool(size_t max_free_blocks) :
+    max_free_blocks(max_free_blocks) { }
+
+    ~body_block_pool() STATICLIB_NOEXCEPT {
+        for (char* bl : free_blocks) {
+            delete[] bl;
+        }
+    }
+
+    body_block_pool(const body_block_pool&) = delete;
+
+    body_block_pool& operator=(const body_block_pool&) = delete;
+
+    char* take() {
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            if (!free_blocks.empty()) {
+                char* bl = free_blocks.back();
+                free_blocks.pop_back();
+                return bl;
+            }
+        }
+        return new char[block_size];
+    }
+
+    void give_back(char* block) STATICLIB_NOEXCEPT {
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            if (free_blocks.size() < max_free_blocks) {
+                free_blocks.push_back(block);
+                return;
+            }
+        }
+        delete[] block;
+    }
+};
+
+// response body, that is kept either in a single buffer (when size
+// is known in advance) or in a list of pooled blocks (rope), body
+// is spilled into an anonymous temporary file after the threshold,
+// spilled body is mapped into memory when the transfer is finished
+class response_body_buffer {
+    std::shared_ptr<body_block_pool> pool;
+    std::vector<char> mem;
+    std::vector<char*> blocks;
+    uint64_t total = 0;
+    uint64_t spill_threshold = 0;
+    std::string spill_dir;
+    // fd or HANDLE
+    intptr_t handle;
+    bool spilled = false;
+    const char* mapped = nullptr;
+    size_t mapped_length = 0;
+#ifdef STATICLIB_WINDOWS
+    intptr_t mapping = 0;
+#endif // STATICLIB_WINDOWS
+
+public:
+    // zero threshold disables spilling
+    response_body_buffer(std::shared_ptr<body_block_pool> pool = std::shared_ptr<body_block_pool>(),
+            uint64_t spill_threshold = 0, const std::string& spill_dir = "");
+
+    ~response_body_buffer() STATICLIB_NOEXCEPT;
+
+    response_body_buffer(const response_body_buffer&) = delete;
+
+    response_body_buffer& operator=(const response_body_buffer&) = delete;
+
+    response_body_buffer(response_body_buffer&& other);
+
+    response_body_buffer& operator=(response_body_buffer&&) = delete;
+
+    // expected body size, must be called before the first append
+    void reserve(uint64_t size);
+
+    void append(const char* data, size_t len);
+
+    uint64_t size() const {
+        return total;
+    }
+
+    bool is_spilled() const {
+        return spilled;
+    }
+
+    // maps spilled file, no appends are allowed after this call
+    void finish();
+
+    // copies data starting from the specified offset, valid after 'finish'
+    size_t read_at(uint64_t offset, sl::io::span<char> dest) const;
+
+    // moves blocks into a single buffer if necessary, valid after 'finish'
+    sl::io::span<const char> flatten();
+
+    // hands over the buffer, copies spilled body, buffer is empty after this call
+    std::vector<char> take();
+
+private:
+    void append_blocks(const char* data, size_t len);
+
+    void release_blocks() STATICLIB_NOEXCEPT;
+
+    void spill();
+
+    void write_file(const char* data, size_t len);
+
+    void close_file() STATICLIB_NOEXCEPT;
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_HTTP_RESPONSE_BODY_BUFFER_HPP */
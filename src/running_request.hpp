@@ -37,12 +37,18 @@
 #include "staticlib/http/request_options.hpp"
 #include "staticlib/http/resource_info.hpp"
 
+#include "batched_file_sink.hpp"
 #include "curl_deleters.hpp"
 #include "curl_headers.hpp"
 #include "curl_info.hpp"
 #include "curl_options.hpp"
+#include "http_probes.hpp"
+#include "metrics_collector.hpp"
 #include "running_request_pipe.hpp"
 #include "request_ticket.hpp"
+#include "request_body_reader.hpp"
+#include "upload_pipe.hpp"
+#include "request_timeline.hpp"
 
 namespace staticlib {
 namespace http {
@@ -53,31 +59,56 @@ class running_request {
     };
 
     // holds data passed to curl
+    uint64_t id;
     std::string url;
     request_options options;
     std::unique_ptr<std::istream> post_data;
+    request_body_reader body;
+    std::shared_ptr<upload_pipe> upload;
     curl_headers headers;
     std::unique_ptr<CURL, curl_easy_deleter> handle;
+    sl::support::observer_ptr<metrics_collector> metrics;
 
     // run details
     std::shared_ptr<running_request_pipe> pipe;
     bool paused = false;
+    bool upload_paused = false;
+    request_timeline timeline;
+    bool done = false;
+    CURLcode result = CURLE_OK;
     std::string error;
     sl::concurrent::growing_buffer buf;
+    std::unique_ptr<batched_file_sink> file_sink;
     req_state state = req_state::created;
 
 public:
-    running_request(CURLM* multi_handle, request_ticket&& ticket) :
+    running_request(CURLM* multi_handle, curl_headers_cache& headers_cache, metrics_collector& metrics,
+            request_ticket&& ticket) :
+    id(ticket.id),
     url(std::move(ticket.url)),
     options(std::move(ticket.options)),
-    post_data(std::move(ticket.post_data)),    
+    post_data(std::move(ticket.post_data)),
+    body(std::move(ticket.body)),
+    upload(std::move(ticket.upload)),
+    headers(headers_cache),
     handle(curl_easy_init(), curl_easy_deleter(multi_handle)),
-    pipe(std::move(ticket.pipe)) {        
+    metrics(sl::support::make_observer_ptr(metrics)),
+    pipe(std::move(ticket.pipe)),
+    timeline(std::move(ticket.timeline)) {
         if (nullptr == handle.get()) throw http_exception(TRACEMSG("Error initializing cURL handle"));
+        if (!options.multi_threaded_response_body_file_path.empty()) {
+            this->file_sink = sl::support::make_unique<batched_file_sink>(
+                    options.multi_threaded_response_body_file_path,
+                    options.multi_threaded_response_body_file_batch_size_bytes,
+                    options.multi_threaded_response_body_file_direct_io);
+        }
         CURLMcode errm = curl_multi_add_handle(multi_handle, handle.get());
         if (errm != CURLM_OK) throw http_exception(TRACEMSG(
                 "cURL multi_add error: [" + curl_multi_strerror(errm) + "], url: [" + this->url + "]"));
-        apply_curl_options(this, this->url, this->options, this->post_data, this->headers, this->handle);
+        timeline.mark_multi_added();
+        STATICLIB_HTTP_PROBE1(multi_add, id);
+        apply_curl_options(this, this->url, this->options, this->post_data, this->body,
+                this->headers, this->handle, nullptr != upload.get());
     }
 
     running_request(const running_request&) = delete;
@@ -87,32 +118,74 @@ public:
     // finalization must be noexcept anyway,
     // so lets tie finalization to destruction
     ~running_request() STATICLIB_NOEXCEPT {
+        timeline.mark_completed();
+        STATICLIB_HTTP_PROBE2(complete, id, static_cast<int> (result));
         auto info = [this] {
             try {
-                return curl_collect_info(handle.get());
+                return curl_collect_info(handle.get(), url);
             } catch (const std::exception& e) {
                 append_error(TRACEMSG(e.what()));
-                return resource_info();
+                return curl_info_snapshot();
             }
         }();
-        pipe->set_resource_info(std::move(info));
+        if (nullptr != file_sink.get()) {
+            try {
+                file_sink->finish();
+            } catch (const std::exception& e) {
+                append_error(TRACEMSG(e.what()));
+            }
+        }
+        metrics->on_finished(info, result, !done);
+        if (done && CURLE_OK != result) {
+            pipe->mark_transfer_failed();
+        }
+        pipe->set_resource_info(std::move(info), timeline.get());
+        // incomplete headers block on abort
+        try {
+            pipe->publish_headers();
+        } catch (const std::exception& e) {
+            append_error(TRACEMSG(e.what()));
+        }
         if (!error.empty()) {
             pipe->append_error(error);
         }
+        if (nullptr != upload.get()) {
+            upload->shutdown_consumer();
+        }
         pipe->shutdown();
     }
 
+    void set_result(CURLcode code) {
+        this->done = true;
+        this->result = code;
+    }
+
     const std::string& get_url() const {
         return url;
     }
 
     bool is_paused() {
-        return paused;
+        return paused || upload_paused;
     }
 
-    void unpause() {
-        this->paused = false;
-        curl_easy_pause(handle.get(), CURLPAUSE_CONT);
+    // returns true if the transfer remains paused
+    bool unpause_if_ready() {
+        bool changed = false;
+        if (paused && !pipe->data_queue_is_full()) {
+            this->paused = false;
+            timeline.mark_unpaused();
+            STATICLIB_HTTP_PROBE1(unpause, id);
+            changed = true;
+        }
+        if (upload_paused && upload->is_readable()) {
+            this->upload_paused = false;
+            changed = true;
+        }
+        if (changed) {
+            int mask = (paused ? CURLPAUSE_RECV : 0) | (upload_paused ? CURLPAUSE_SEND : 0);
+            curl_easy_pause(handle.get(), mask);
+        }
+        return is_paused();
     }
 
     void append_error(const std::string& msg) {
@@ -138,11 +211,13 @@ public:
 
     // http://stackoverflow.com/a/9681122/314015
     size_t write_headers(char* buffer, size_t size, size_t nitems) {
+        timeline.mark_first_header();
         if (req_state::created == state) {
             curl_info ci(handle.get());
             long code = ci.getinfo_long(CURLINFO_RESPONSE_CODE);
             // https://curl.haxx.se/mail/lib-2011-03/0160.html
             if (100 != code) {
+                STATICLIB_HTTP_PROBE2(first_header, id, code);
                 pipe->set_response_code(code);
                 if (options.abort_on_response_error && code >= 400) {
                     append_error(TRACEMSG("HTTP response error, status code: [" + sl::support::to_string(code) + "]"));
@@ -158,6 +233,9 @@ public:
         auto opt = curl_parse_header(buffer, len);
         if (opt) {
             pipe->emplace_header(std::move(opt.value()));
+        } else if (curl_header_is_blank(buffer, len)) {
+            // blank line, end of headers block
+            pipe->publish_headers();
         }
         return len;
     }
@@ -165,17 +243,34 @@ public:
     size_t write_data(char* buffer, size_t size, size_t nitems) {
         if (req_state::receiving_headers == state) {
             state = req_state::receiving_data;
+            timeline.mark_first_byte();
+            if (nullptr != file_sink.get()) {
+                // wakes up consumer waiting for the status code
+                pipe->write_some_data(sl::concurrent::growing_buffer());
+            }
         } else if (req_state::receiving_data != state) {
             append_error(TRACEMSG("System error: invalid state on 'write_data'"));
             return 0;
         }
         size_t len = size * nitems;
+        STATICLIB_HTTP_PROBE2(write_data, id, len);
+        if (nullptr != file_sink.get()) {
+            try {
+                file_sink->write({buffer, len});
+            } catch (const std::exception& e) {
+                append_error(TRACEMSG(e.what()));
+                return 0;
+            }
+            return len;
+        }
         // chunk is too big for stack
         buf.resize(len);
         std::memcpy(buf.data(), buffer, buf.size());
         bool placed = pipe->write_some_data(std::move(buf));
         if (!placed) {
             paused = true;
+            timeline.mark_paused();
+            STATICLIB_HTTP_PROBE1(pause, id);
             return CURL_WRITEFUNC_PAUSE;
         }
         return len;
@@ -183,10 +278,39 @@ public:
 
     size_t read_data(char* buffer, size_t size, size_t nitems) {
         size_t len = size * nitems;
+        if (nullptr != upload.get()) {
+            return read_upload(buffer, len);
+        }
+        if (body.get_body().is_present()) {
+            return body.read(buffer, len);
+        }
         auto src = sl::io::streambuf_source(post_data->rdbuf());
         std::streamsize read = sl::io::read_all(src, {buffer, len});
         return static_cast<size_t> (read);
     }
+
+private:
+    size_t read_upload(char* buffer, size_t len) {
+        size_t read = upload->read_some(buffer, len);
+        if (read > 0) {
+            return read;
+        }
+        upload->set_consumer_waiting();
+        // checked again after the flag is set
+        read = upload->read_some(buffer, len);
+        if (read > 0) {
+            return read;
+        }
+        if (upload->is_aborted()) {
+            append_error(TRACEMSG("Request body upload aborted by client"));
+            return CURL_READFUNC_ABORT;
+        }
+        if (upload->is_finished()) {
+            return 0;
+        }
+        this->upload_paused = true;
+        return CURL_READFUNC_PAUSE;
+    }
 };
 
 } // namespace
@@ -27,6 +27,7 @@
 #include <cstdint>
 #include <atomic>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -37,16 +38,32 @@
 #include "staticlib/http/http_exception.hpp"
 #include "staticlib/http/request_options.hpp"
 #include "staticlib/http/resource_info.hpp"
+#include "staticlib/http/resource_timeline.hpp"
+
+#include "curl_info.hpp"
 
 namespace staticlib {
 namespace http {
 
 class running_request_pipe : public std::enable_shared_from_this<running_request_pipe> {
+public:
+    using headers_type = std::vector<std::pair<std::string, std::string>>;
+
+private:
     std::atomic<int16_t> response_code;
-    sl::concurrent::spsc_inobject_concurrent_queue<resource_info, 1> res_info;
+    // written once by worker before publishing the flag
+    curl_info_snapshot res_info;
+    resource_timeline timeline;
+    std::atomic<bool> res_info_ready;
     sl::concurrent::spsc_inobject_waiting_queue<sl::concurrent::growing_buffer, 16> data_queue;
-    sl::concurrent::spsc_concurrent_queue<std::pair<std::string, std::string>> headers_queue;
+    // accessed only by worker
+    headers_type headers_pending;
+    size_t headers_count;
+    uint16_t max_number_of_response_headers;
+    // immutable snapshot, accessed with atomic_load/atomic_store
+    std::shared_ptr<const headers_type> headers_published;
     std::atomic<bool> errors_non_empty;
+    std::atomic<bool> transfer_failed;
     sl::concurrent::mpmc_blocking_queue<std::string> errors;
     std::shared_ptr<sl::concurrent::condition_latch> pause_latch;
     uint16_t consumer_thread_wakeup_timeout_millis;
@@ -56,8 +73,12 @@ public:
     running_request_pipe(request_options& opts, 
             std::shared_ptr<sl::concurrent::condition_latch> pause_latch) :
     response_code(0),
-    headers_queue(opts.max_number_of_response_headers),
+    res_info_ready(false),
+    headers_count(0),
+    max_number_of_response_headers(opts.max_number_of_response_headers),
+    headers_published(std::make_shared<const headers_type>()),
     errors_non_empty(false),
+    transfer_failed(false),
     errors(std::numeric_limits<uint16_t>::max()),
     pause_latch(std::move(pause_latch)),
     consumer_thread_wakeup_timeout_millis(opts.consumer_thread_wakeup_timeout_millis),
@@ -83,16 +104,28 @@ public:
         return response_code.load(std::memory_order_acquire);
     }
 
-    void set_resource_info(resource_info&& info) {
-        if (res_info.size() > 0) throw http_exception(TRACEMSG(
+    void set_resource_info(curl_info_snapshot&& info, const resource_timeline& tl) {
+        if (res_info_ready.load(std::memory_order_acquire)) throw http_exception(TRACEMSG(
                 "Invalid second attempt to set resource info"));
-        res_info.emplace(std::move(info));
+        this->res_info = std::move(info);
+        this->timeline = tl;
+        res_info_ready.store(true, std::memory_order_release);
+    }
+
+    // snapshot is immutable after it is published,
+    // so it can be converted any number of times
+    resource_info get_resource_info(const std::string& url) const {
+        if (!res_info_ready.load(std::memory_order_acquire)) {
+            return resource_info();
+        }
+        return res_info.to_resource_info(url);
     }
 
-    resource_info get_resource_info() {
-        resource_info res;
-        res_info.poll(res);
-        return res;
+    resource_timeline get_timeline() const {
+        if (!res_info_ready.load(std::memory_order_acquire)) {
+            return resource_timeline();
+        }
+        return timeline;
     }
 
     bool write_some_data(sl::concurrent::growing_buffer&& buf) {
@@ -137,20 +170,41 @@ public:
         return data_queue.full();
     }
 
+    bool is_running() const {
+        return running.load(std::memory_order_acquire);
+    }
+
+    // called by worker, header lines are accumulated
+    // until the end of the headers block
     void emplace_header(std::pair<std::string, std::string>&& pair) {
-        bool emplaced = headers_queue.emplace(std::move(pair));
-        if (!emplaced) throw http_exception(TRACEMSG(
-                "Error emplacing header to queue, " +
-                "queue size: [" + sl::support::to_string(headers_queue.max_size()) + "]"));
+        if (headers_count >= max_number_of_response_headers) throw http_exception(TRACEMSG(
+                "Error emplacing header, max number of headers exceeded, " +
+                "limit: [" + sl::support::to_string(max_number_of_response_headers) + "]"));
+        headers_pending.emplace_back(std::move(pair));
+        headers_count += 1;
     }
 
-    std::vector<std::pair<std::string, std::string>> consume_received_headers() {
-        std::vector<std::pair<std::string, std::string>> res;
-        auto pa = std::pair<std::string, std::string>();
-        while (headers_queue.poll(pa)) {
-            res.emplace_back(std::move(pa));
+    // called by worker on the blank line, that ends the headers block,
+    // normally happens once per request, additional blocks
+    // (redirects, trailers) are appended to the previous snapshot
+    void publish_headers() {
+        if (headers_pending.empty()) return;
+        // worker is the only writer, so plain load is safe here
+        auto& prev = *headers_published;
+        auto block = std::make_shared<headers_type>();
+        block->reserve(prev.size() + headers_pending.size());
+        block->insert(block->end(), prev.begin(), prev.end());
+        for (auto& pa : headers_pending) {
+            block->emplace_back(std::move(pa));
         }
-        return res;
+        headers_pending.clear();
+        std::shared_ptr<const headers_type> snapshot = std::move(block);
+        std::atomic_store_explicit(std::addressof(headers_published), std::move(snapshot),
+                std::memory_order_release);
+    }
+
+    std::shared_ptr<const headers_type> get_headers() const {
+        return std::atomic_load_explicit(std::addressof(headers_published), std::memory_order_acquire);
     }
 
     void append_error(const std::string& msg) STATICLIB_NOEXCEPT {
@@ -173,6 +227,16 @@ public:
         return errors_non_empty.load(std::memory_order_acquire);
     }
 
+    // set by worker before shutdown, when transfer
+    // was finished by cURL with an error
+    void mark_transfer_failed() {
+        transfer_failed.store(true, std::memory_order_release);
+    }
+
+    bool is_transfer_failed() const {
+        return transfer_failed.load(std::memory_order_acquire);
+    }
+
 };
 
 } // namespace
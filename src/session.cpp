@@ -32,7 +32,8 @@ namespace http {
 
 session::impl::impl(session_options opts) :
 options(opts),
-handle(curl_multi_init(), curl_multi_deleter()) {
+handle(curl_multi_init(), curl_multi_deleter()),
+headers_cache(opts.request_headers_cache_max_size) {
     this->resource_id.store(1, std::memory_order_release);
     if (nullptr == handle.get()) throw http_exception(TRACEMSG("Error initializing cURL multi handle"));
     apply_curl_multi_options(this->handle.get(), this->options);
@@ -70,5 +71,10 @@ resource session::impl::open_url(session& frontend,
 }
 PIMPL_FORWARD_METHOD(session, resource, open_url, (const std::string&)(std::streambuf*)(request_options), (), http_exception)
 
+session_metrics session::impl::get_metrics(const session&) const {
+    return metrics.snapshot();
+}
+PIMPL_FORWARD_METHOD(session, session_metrics, get_metrics, (), (const), http_exception)
+
 } // namespace
 }
@@ -32,6 +32,8 @@
 #include "curl/curl.h"
 
 #include "curl_deleters.hpp"
+#include "curl_headers_cache.hpp"
+#include "metrics_collector.hpp"
 
 namespace staticlib {
 namespace http {
@@ -41,6 +43,8 @@ protected:
     std::atomic<uint64_t> resource_id;
     session_options options;
     std::unique_ptr<CURLM, curl_multi_deleter> handle;
+    curl_headers_cache headers_cache;
+    metrics_collector metrics;
 
     uint64_t increment_resource_id();
 
@@ -58,6 +62,8 @@ public:
             std::streambuf* post_data,
             request_options opts);
 
+    session_metrics get_metrics(const session&) const;
+
 };
 
 } // namespace
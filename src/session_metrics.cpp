@@ -0,0 +1,113 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   session_metrics.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 4:48 PM
+ */
+
+#include "staticlib/http/session_metrics.hpp"
+
+#include "staticlib/config.hpp"
+#include "staticlib/support.hpp"
+
+namespace staticlib {
+namespace http {
+
+namespace { // anonymous
+
+std::string micros_to_secs_string(uint64_t micros) {
+    auto frac = sl::support::to_string(micros % 1000000);
+    return sl::support::to_string(micros / 1000000) + "." +
+            std::string(6 - frac.length(), '0') + frac;
+}
+
+void append_counter(std::string& dest, const std::string& name, uint64_t value) {
+    dest.append("# TYPE ").append(name).append(" counter\n");
+    dest.append(name).append(" ").append(sl::support::to_string(value)).append("\n");
+}
+
+void append_gauge(std::string& dest, const std::string& name, int64_t value) {
+    dest.append("# TYPE ").append(name).append(" gauge\n");
+    dest.append(name).append(" ").append(sl::support::to_string(value)).append("\n");
+}
+
+// buckets are exported only on power of two boundaries
+// to keep the output reasonably short
+void append_histogram(std::string& dest, const std::string& name, const latency_histogram& hist) {
+    dest.append("# TYPE ").append(name).append(" histogram\n");
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < hist.counts.size() && i < hist.bounds_micros.size(); i++) {
+        cumulative += hist.counts[i];
+        uint64_t bound = hist.bounds_micros[i];
+        if (bound > 0 && 0 == ((bound + 1) & bound)) {
+            dest.append(name).append("_bucket{le=\"").append(micros_to_secs_string(bound)).append("\"} ")
+                    .append(sl::support::to_string(cumulative)).append("\n");
+        }
+    }
+    dest.append(name).append("_bucket{le=\"+Inf\"} ").append(sl::support::to_string(hist.count)).append("\n");
+    dest.append(name).append("_sum ").append(micros_to_secs_string(hist.sum_micros)).append("\n");
+    dest.append(name).append("_count ").append(sl::support::to_string(hist.count)).append("\n");
+}
+
+} // namespace
+
+uint64_t latency_histogram::percentile_micros(double percentile) const {
+    if (0 == count || counts.empty()) {
+        return 0;
+    }
+    double pct = percentile < 0 ? 0 : (percentile > 100 ? 100 : percentile);
+    uint64_t target = static_cast<uint64_t> (static_cast<double> (count) * pct / 100);
+    if (0 == target) {
+        target = 1;
+    }
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < counts.size() && i < bounds_micros.size(); i++) {
+        cumulative += counts[i];
+        if (cumulative >= target) {
+            return bounds_micros[i];
+        }
+    }
+    return bounds_micros.empty() ? 0 : bounds_micros.back();
+}
+
+std::string metrics_to_prometheus_text(const session_metrics& metrics, const std::string& prefix) {
+    std::string res;
+    append_counter(res, prefix + "_requests_submitted_total", metrics.requests_submitted);
+    append_counter(res, prefix + "_requests_completed_total", metrics.requests_completed);
+    append_counter(res, prefix + "_requests_failed_total", metrics.requests_failed);
+    append_gauge(res, prefix + "_requests_in_flight", metrics.requests_in_flight);
+    append_gauge(res, prefix + "_requests_queued", metrics.requests_queued);
+    append_gauge(res, prefix + "_transfers_paused", metrics.transfers_paused);
+    append_counter(res, prefix + "_received_bytes_total", metrics.bytes_received);
+    append_counter(res, prefix + "_sent_bytes_total", metrics.bytes_sent);
+    append_counter(res, prefix + "_new_connections_total", metrics.new_connections);
+    auto errors_name = prefix + "_curl_errors_total";
+    res.append("# TYPE ").append(errors_name).append(" counter\n");
+    for (auto& pa : metrics.errors_by_curl_code) {
+        res.append(errors_name).append("{code=\"").append(sl::support::to_string(pa.first)).append("\"} ")
+                .append(sl::support::to_string(pa.second)).append("\n");
+    }
+    append_histogram(res, prefix + "_request_duration_seconds", metrics.total_time);
+    append_histogram(res, prefix + "_time_to_first_byte_seconds", metrics.ttfb);
+    append_histogram(res, prefix + "_queue_time_seconds", metrics.queue_time);
+    return res;
+}
+
+} // namespace
+}
@@ -38,6 +38,10 @@
 #include "curl_info.hpp"
 #include "curl_options.hpp"
 #include "curl_utils.hpp"
+#include "http_probes.hpp"
+#include "metrics_collector.hpp"
+#include "request_body_reader.hpp"
+#include "request_timeline.hpp"
 #include "resource_impl.hpp"
 
 namespace staticlib {
@@ -60,16 +64,21 @@ class single_threaded_resource::impl : public resource::impl {
     uint64_t id;
     CURLM* multi_handle;
     std::unique_ptr<CURL, curl_easy_deleter> handle;
+    sl::support::observer_ptr<metrics_collector> metrics;
 
     // holds data passed to curl
     std::string url;
     session_options session_opts;
     request_options options;
     std::unique_ptr<std::istream> post_data;
+    request_body_reader body;
     curl_headers request_headers;
 
     // run details
-    resource_info info;
+    mutable curl_info_snapshot info;
+    bool finished = false;
+    CURLcode result = CURLE_OK;
+    request_timeline timeline;
     uint16_t status_code = 0;
     std::vector<std::pair<std::string, std::string>> response_headers;
     std::vector<char> buf;
@@ -80,21 +89,51 @@ class single_threaded_resource::impl : public resource::impl {
 
 public:
     impl(uint64_t resource_id, CURLM* multi_handle, const session_options& session_opts,
-            const std::string& url, std::unique_ptr<std::istream> post_data,
-            request_options options, std::function<void()> finalizer) :
+            const std::string& url, std::unique_ptr<std::istream> post_data, request_body body,
+            request_options options, curl_headers_cache& headers_cache,
+            metrics_collector& metrics, std::function<void()> finalizer) :
     id(resource_id),
     multi_handle(multi_handle),
     handle(curl_easy_init(), curl_easy_deleter(this->multi_handle, finalizer)),
+    metrics(sl::support::make_observer_ptr(metrics)),
     url(url.data(), url.length()),
     session_opts(session_opts),
     options(std::move(options)),
-    post_data(std::move(post_data)) {
+    post_data(std::move(post_data)),
+    body(std::move(body)),
+    request_headers(headers_cache),
+    timeline(this->options.record_timeline) {
+        timeline.mark_submitted();
         CURLMcode errm = curl_multi_add_handle(multi_handle, handle.get());
         if (errm != CURLM_OK) throw http_exception(TRACEMSG(
                 "cURL multi_add error: [" + curl_multi_strerror(errm) + "], url: [" + this->url + "]"));
-        apply_curl_options(this, this->url, this->options, this->post_data, this->request_headers, this->handle);
-        this->open = true;
-        fill_buffer();
+        timeline.mark_multi_added();
+        STATICLIB_HTTP_PROBE1(multi_add, id);
+        this->metrics->on_submitted(false);
+        try {
+            apply_curl_options(this, this->url, this->options, this->post_data, this->body,
+                    this->request_headers, this->handle);
+            this->open = true;
+            fill_buffer();
+        } catch (...) {
+            // destructor is not called
+            this->metrics->on_finished(curl_info_snapshot(), CURLE_OK, true);
+            throw;
+        }
+    }
+
+    ~impl() STATICLIB_NOEXCEPT {
+        bool success = finished && error.empty();
+        if (success && !info.is_collected()) {
+            try {
+                info.collect(handle.get(), url);
+            } catch (const std::exception&) {
+                // info is optional for metrics
+            }
+        }
+        // errors reported by callbacks abort the transfer
+        bool aborted = !finished || (CURLE_OK == result && !error.empty());
+        metrics->on_finished(info, result, aborted);
     }
 
     virtual std::streamsize read(resource&, sl::io::span<char> span) override {
@@ -104,7 +143,14 @@ public:
             if (open) {
                 return 0;
             } else {
-                this->info = curl_collect_info(handle.get());
+                // handle is kept until destruction,
+                // info is collected on demand
+                if (!finished) {
+                    timeline.mark_completed();
+                    STATICLIB_HTTP_PROBE2(complete, id, 0);
+                    this->finished = true;
+                }
+                timeline.mark_consumer_eof();
                 return std::char_traits<char>::eof();
             }
         }
@@ -113,6 +159,7 @@ public:
         size_t reslen = avail <= ulen ? avail : ulen;
         std::memcpy(span.data(), buf.data(), reslen);
         buf_idx += reslen;
+        STATICLIB_HTTP_PROBE2(consumer_read, id, reslen);
         return static_cast<std::streamsize> (reslen);
     }
 
@@ -125,7 +172,14 @@ public:
     }
 
     virtual resource_info get_info(const resource&) const override {
-        return info;
+        if (finished && !info.is_collected()) {
+            info.collect(handle.get(), url);
+        }
+        return info.to_resource_info(url);
+    }
+
+    virtual resource_timeline get_timeline(const resource&) const override {
+        return timeline.get();
     }
 
     virtual const std::vector<std::pair<std::string, std::string>>& get_headers(const resource&) const override {
@@ -158,9 +212,11 @@ public:
     }
 
     size_t write_headers(char* buffer, size_t size, size_t nitems) {
+        timeline.mark_first_header();
         if (resource_state::created == state) {
             curl_info ci(handle.get());
             this->status_code = static_cast<uint16_t>(ci.getinfo_long(CURLINFO_RESPONSE_CODE));
+            STATICLIB_HTTP_PROBE2(first_header, id, status_code);
             this->state = resource_state::writing_headers;
         }
         size_t len = size*nitems;
@@ -172,13 +228,18 @@ public:
     }
 
     size_t write_data(char *buffer, size_t size, size_t nitems) {
+        timeline.mark_first_byte();
         size_t len = size*nitems;
+        STATICLIB_HTTP_PROBE2(write_data, id, len);
         buf.resize(len);
         std::memcpy(buf.data(), buffer, len);
         return len;
     }
 
     size_t read_data(char* buffer, size_t size, size_t nitems) {
+        if (body.get_body().is_present()) {
+            return body.read(buffer, size * nitems);
+        }
         std::streamsize len = static_cast<std::streamsize> (size * nitems);
         sl::io::streambuf_source src{post_data->rdbuf()};
         std::streamsize read = sl::io::read_all(src,{buffer, len});
@@ -236,12 +297,25 @@ private:
                 if (err != CURLM_OK) throw http_exception(TRACEMSG(
                         "cURL multi_perform error: [" + curl_multi_strerror(err) + "], url: [" + url + "]"));
                 open = (1 == active);
+                if (!open) {
+                    collect_result();
+                }
             }
 
             check_state_after_perform(start);
         }
     }
 
+    void collect_result() {
+        int msgs_left = 0;
+        CURLMsg* msg = nullptr;
+        while (nullptr != (msg = curl_multi_info_read(multi_handle, std::addressof(msgs_left)))) {
+            if (CURLMSG_DONE == msg->msg && handle.get() == msg->easy_handle) {
+                this->result = msg->data.result;
+            }
+        }
+    }
+
     void check_state_after_perform(std::chrono::time_point<std::chrono::system_clock> start) {
         // check whether error happened
         if(!error.empty()) {
@@ -273,11 +347,12 @@ private:
     }
 };
 
-PIMPL_FORWARD_CONSTRUCTOR(single_threaded_resource, (uint64_t)(CURLM*)(const session_options&)(const std::string&)(std::unique_ptr<std::istream>)(request_options)(fin_type), (), http_exception)
+PIMPL_FORWARD_CONSTRUCTOR(single_threaded_resource, (uint64_t)(CURLM*)(const session_options&)(const std::string&)(std::unique_ptr<std::istream>)(request_body)(request_options)(curl_headers_cache&)(metrics_collector&)(fin_type), (), http_exception)
 PIMPL_FORWARD_METHOD(single_threaded_resource, std::streamsize, read, (sl::io::span<char>), (), http_exception)
 PIMPL_FORWARD_METHOD(single_threaded_resource, const std::string&, get_url, (), (const), http_exception)
 PIMPL_FORWARD_METHOD(single_threaded_resource, uint16_t, get_status_code, (), (const), http_exception)
 PIMPL_FORWARD_METHOD(single_threaded_resource, resource_info, get_info, (), (const), http_exception)
+PIMPL_FORWARD_METHOD(single_threaded_resource, resource_timeline, get_timeline, (), (const), http_exception)
 PIMPL_FORWARD_METHOD(single_threaded_resource, headers_type, get_headers, (), (const), http_exception)
 PIMPL_FORWARD_METHOD(single_threaded_resource, const std::string&, get_header, (const std::string&), (const), http_exception)
 PIMPL_FORWARD_METHOD(single_threaded_resource, bool, connection_successful, (), (const), http_exception)
@@ -30,12 +30,17 @@
 
 #include "curl/curl.h"
 
+#include "staticlib/http/request_body.hpp"
 #include "staticlib/http/request_options.hpp"
 #include "staticlib/http/session_options.hpp"
 
 namespace staticlib {
 namespace http {
 
+// forward decl
+class curl_headers_cache;
+class metrics_collector;
+
 class single_threaded_resource : public resource {
 protected:
     class impl;
@@ -45,8 +50,9 @@ public:
 
     single_threaded_resource(uint64_t resource_id, CURLM* multi_handle,
             const session_options& session_options, const std::string& url,
-            std::unique_ptr<std::istream> post_data,
-            request_options options, std::function<void()> finalizer);
+            std::unique_ptr<std::istream> post_data, request_body body,
+            request_options options, curl_headers_cache& headers_cache,
+            metrics_collector& metrics, std::function<void()> finalizer);
 
     virtual std::streamsize read(sl::io::span<char> span) override;
 
@@ -56,6 +62,8 @@ public:
 
     virtual resource_info get_info() const override;
 
+    virtual resource_timeline get_timeline() const override;
+
     virtual const std::vector<std::pair<std::string, std::string>>& get_headers() const override;
 
     virtual const std::string& get_header(const std::string& name) const override;
@@ -43,6 +43,17 @@ public:
     session::impl(opts) { }
     resource open_url(single_threaded_session&, const std::string& url,
             std::unique_ptr<std::istream> post_data, request_options opts) {
+        return open_resource(url, std::move(post_data), request_body(), std::move(opts));
+    }
+
+    resource open_url(single_threaded_session&, const std::string& url,
+            request_body body, request_options opts) {
+        return open_resource(url, std::unique_ptr<std::istream>(), std::move(body), std::move(opts));
+    }
+
+private:
+    resource open_resource(const std::string& url, std::unique_ptr<std::istream> post_data,
+            request_body body, request_options opts) {
         if (has_active_request) throw http_exception(TRACEMSG(
                 "This single-threaded session is already has one HTTP resource open, please dispose it first"));
         if ("" == opts.method) {
@@ -50,13 +61,14 @@ public:
         }
         this->has_active_request = true;
         return single_threaded_resource(increment_resource_id(), handle.get(), this->options, std::move(url), 
-                std::move(post_data), std::move(opts), [this] {this->has_active_request = false; });
+                std::move(post_data), std::move(body), std::move(opts), headers_cache, metrics, [this] {this->has_active_request = false; });
     }
 
 };
 
 PIMPL_FORWARD_CONSTRUCTOR(single_threaded_session, (session_options), (), http_exception)
 PIMPL_FORWARD_METHOD(single_threaded_session, resource, open_url, (const std::string&)(std::unique_ptr<std::istream>)(request_options), (), http_exception)
+PIMPL_FORWARD_METHOD(single_threaded_session, resource, open_url, (const std::string&)(request_body)(request_options), (), http_exception)
 
 } // namespace
 }
@@ -0,0 +1,213 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   upload_pipe.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 8:10 PM
+ */
+
+#ifndef STATICLIB_HTTP_UPLOAD_PIPE_HPP
+#define STATICLIB_HTTP_UPLOAD_PIPE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#include "staticlib/concurrent.hpp"
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+
+#include "staticlib/http/http_exception.hpp"
+
+namespace staticlib {
+namespace http {
+
+// forward decl
+class upload_stream;
+
+// request body chunks pushed by the client thread and pulled
+// by the worker from cURL read callback, the worker never blocks
+// here, client blocks (on the slow path only) when the pipe is full
+class upload_pipe {
+    sl::concurrent::spsc_concurrent_queue<sl::concurrent::growing_buffer> chunks;
+    std::atomic<bool> closed;
+    std::atomic<bool> aborted;
+    std::atomic<bool> consumer_gone;
+    // set by the worker when read callback was paused
+    std::atomic<bool> consumer_waiting;
+    // accessed with atomic_load/atomic_store, attached on submission
+    std::shared_ptr<sl::concurrent::condition_latch> consumer_wakeup;
+
+    // producer waits here when the queue is full
+    std::atomic<bool> producer_waiting;
+    std::mutex producer_mutex;
+    std::condition_variable producer_cv;
+
+    // worker-only, partially consumed chunk
+    sl::concurrent::growing_buffer current;
+    size_t current_idx;
+
+public:
+    upload_pipe(uint16_t max_chunks) :
+    chunks(max_chunks),
+    closed(false),
+    aborted(false),
+    consumer_gone(false),
+    consumer_waiting(false),
+    producer_waiting(false),
+    current_idx(0) { }
+
+    upload_pipe(const upload_pipe&) = delete;
+
+    upload_pipe& operator=(const upload_pipe&) = delete;
+
+    // client thread
+
+    bool try_write(sl::io::span<const char> span) {
+        check_writable();
+        if (0 == span.size()) {
+            return true;
+        }
+        // single producer, free slot cannot be taken
+        // before emplace, chunk is not copied on retries
+        if (chunks.full()) {
+            return false;
+        }
+        auto buf = sl::concurrent::growing_buffer();
+        buf.resize(span.size());
+        std::memcpy(buf.data(), span.data(), span.size());
+        bool placed = chunks.emplace(std::move(buf));
+        if (placed) {
+            notify_consumer();
+        }
+        return placed;
+    }
+
+    std::streamsize write(sl::io::span<const char> span) {
+        while (!try_write(span)) {
+            std::unique_lock<std::mutex> guard{producer_mutex};
+            producer_waiting.store(true, std::memory_order_seq_cst);
+            if (chunks.full() && !consumer_gone.load(std::memory_order_acquire)) {
+                // timeout is a safety net only, consumer notifies after every poll
+                producer_cv.wait_for(guard, std::chrono::milliseconds(100));
+            }
+            producer_waiting.store(false, std::memory_order_relaxed);
+        }
+        return static_cast<std::streamsize> (span.size());
+    }
+
+    void close() {
+        closed.store(true, std::memory_order_release);
+        notify_consumer();
+    }
+
+    void abort() STATICLIB_NOEXCEPT {
+        aborted.store(true, std::memory_order_release);
+        notify_consumer();
+    }
+
+    void attach_consumer(std::shared_ptr<sl::concurrent::condition_latch> wakeup) {
+        std::atomic_store_explicit(std::addressof(consumer_wakeup), std::move(wakeup), std::memory_order_release);
+    }
+
+    // worker thread
+
+    // zero is returned when no data is available, check
+    // 'is_finished' to distinguish the end of the body
+    size_t read_some(char* buffer, size_t len) {
+        size_t written = 0;
+        while (written < len) {
+            if (current_idx == current.size()) {
+                current_idx = 0;
+                current.resize(0);
+                if (!chunks.poll(current)) {
+                    break;
+                }
+                notify_producer();
+            }
+            size_t avail = current.size() - current_idx;
+            size_t chunk = avail <= len - written ? avail : len - written;
+            std::memcpy(buffer + written, current.data() + current_idx, chunk);
+            current_idx += chunk;
+            written += chunk;
+        }
+        return written;
+    }
+
+    // flag must be set before the final emptiness check, so
+    // the data written after that check wakes up the worker
+    void set_consumer_waiting() {
+        consumer_waiting.store(true, std::memory_order_seq_cst);
+    }
+
+    bool is_readable() {
+        return current_idx < current.size() || !chunks.empty() ||
+                closed.load(std::memory_order_acquire) || aborted.load(std::memory_order_acquire);
+    }
+
+    bool is_finished() {
+        return closed.load(std::memory_order_acquire) && current_idx == current.size() && chunks.empty();
+    }
+
+    bool is_aborted() {
+        return aborted.load(std::memory_order_acquire);
+    }
+
+    void shutdown_consumer() STATICLIB_NOEXCEPT {
+        consumer_gone.store(true, std::memory_order_release);
+        notify_producer();
+    }
+
+private:
+    void check_writable() {
+        if (closed.load(std::memory_order_acquire)) throw http_exception(TRACEMSG(
+                "Invalid write attempt into closed upload stream"));
+        if (consumer_gone.load(std::memory_order_acquire)) throw http_exception(TRACEMSG(
+                "Upload stream is not accepting data, request is finished"));
+    }
+
+    void notify_consumer() {
+        bool waiting = consumer_waiting.exchange(false, std::memory_order_seq_cst);
+        if (waiting) {
+            auto wakeup = std::atomic_load_explicit(std::addressof(consumer_wakeup), std::memory_order_acquire);
+            if (nullptr != wakeup.get()) {
+                wakeup->notify_one();
+            }
+        }
+    }
+
+    void notify_producer() {
+        if (producer_waiting.load(std::memory_order_seq_cst)) {
+            std::lock_guard<std::mutex> guard{producer_mutex};
+            producer_cv.notify_one();
+        }
+    }
+};
+
+// defined in upload_stream.cpp
+std::shared_ptr<upload_pipe> get_upload_pipe(upload_stream& stream);
+
+} // namespace
+}
+
+#endif /* STATICLIB_HTTP_UPLOAD_PIPE_HPP */
+
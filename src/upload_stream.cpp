@@ -0,0 +1,89 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   upload_stream.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 8:31 PM
+ */
+
+#include "staticlib/http/upload_stream.hpp"
+
+#include "staticlib/pimpl/forward_macros.hpp"
+
+#include "upload_pipe.hpp"
+
+namespace staticlib {
+namespace http {
+
+class upload_stream::impl : public sl::pimpl::object::impl {
+    std::shared_ptr<upload_pipe> pipe;
+    bool closed = false;
+
+public:
+    impl(uint16_t max_chunks) :
+    pipe(std::make_shared<upload_pipe>(max_chunks)) {
+        if (0 == max_chunks) throw http_exception(TRACEMSG(
+                "Invalid zero 'max_chunks' specified for upload stream"));
+    }
+
+    ~impl() STATICLIB_NOEXCEPT {
+        if (!closed) {
+            pipe->abort();
+        }
+    }
+
+    std::streamsize write(upload_stream&, sl::io::span<const char> span) {
+        return pipe->write(span);
+    }
+
+    bool try_write(upload_stream&, sl::io::span<const char> span) {
+        return pipe->try_write(span);
+    }
+
+    std::streamsize flush(upload_stream&) {
+        return 0;
+    }
+
+    void close(upload_stream&) {
+        this->closed = true;
+        pipe->close();
+    }
+
+    void abort(upload_stream&) {
+        this->closed = true;
+        pipe->abort();
+    }
+
+    std::shared_ptr<upload_pipe> get_pipe() {
+        return pipe;
+    }
+};
+PIMPL_FORWARD_CONSTRUCTOR(upload_stream, (uint16_t), (), http_exception)
+PIMPL_FORWARD_METHOD(upload_stream, std::streamsize, write, (sl::io::span<const char>), (), http_exception)
+PIMPL_FORWARD_METHOD(upload_stream, bool, try_write, (sl::io::span<const char>), (), http_exception)
+PIMPL_FORWARD_METHOD(upload_stream, std::streamsize, flush, (), (), http_exception)
+PIMPL_FORWARD_METHOD(upload_stream, void, close, (), (), http_exception)
+PIMPL_FORWARD_METHOD(upload_stream, void, abort, (), (), http_exception)
+
+std::shared_ptr<upload_pipe> get_upload_pipe(upload_stream& stream) {
+    auto impl_ptr = static_cast<upload_stream::impl*> (stream.get_impl_ptr().get());
+    return impl_ptr->get_pipe();
+}
+
+} // namespace
+}
@@ -0,0 +1,336 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   alloc_bench.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 7:05 PM
+ */
+
+// Allocations accounting, counts C++ allocations (global operator new)
+// and cURL allocations (curl_global_init_mem) per request for every
+// session type, reports RSS growth over the run.
+// Server runs in a forked child process, so its allocations are not counted,
+// OpenSSL allocations are not counted either.
+// Exits with non-zero code if the per-request budget is exceeded.
+//
+// Usage (from the build directory, Linux only):
+//
+//     ./staticlib_http_alloc_bench [sessions=single,multi,polling] [payloads=small,1m]
+//             [requests=10000] [budget_allocs=0] [budget_bytes=0]
+//
+// Use 'requests=1000000' for a soak run, zero budget means no limit.
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "curl/curl.h"
+
+#include "staticlib/pion.hpp"
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/http.hpp"
+
+namespace { // anonymous
+
+const uint16_t TCP_PORT = 8080;
+const uint32_t WARMUP_REQUESTS = 100;
+const std::string SMALL_JSON = "{\"id\": 42, \"name\": \"staticlib_http\", \"tags\": [\"bench\", \"alloc\"]}";
+
+std::atomic<uint64_t> allocs_count{0};
+std::atomic<uint64_t> allocs_bytes{0};
+
+void count_alloc(size_t size) {
+    allocs_count.fetch_add(1, std::memory_order_relaxed);
+    allocs_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+// cURL memory callbacks
+
+void* curl_malloc_cb(size_t size) {
+    count_alloc(size);
+    return std::malloc(size);
+}
+
+void curl_free_cb(void* ptr) {
+    std::free(ptr);
+}
+
+void* curl_realloc_cb(void* ptr, size_t size) {
+    count_alloc(size);
+    return std::realloc(ptr, size);
+}
+
+char* curl_strdup_cb(const char* str) {
+    size_t len = std::strlen(str) + 1;
+    count_alloc(len);
+    auto res = static_cast<char*> (std::malloc(len));
+    if (nullptr != res) {
+        std::memcpy(res, str, len);
+    }
+    return res;
+}
+
+void* curl_calloc_cb(size_t nmemb, size_t size) {
+    count_alloc(nmemb * size);
+    return std::calloc(nmemb, size);
+}
+
+struct bench_config {
+    std::vector<std::string> sessions = {"single", "multi", "polling"};
+    std::vector<std::string> payloads = {"small", "1m"};
+    uint32_t requests = 10000;
+    uint64_t budget_allocs = 0;
+    uint64_t budget_bytes = 0;
+};
+
+uint64_t rss_kb() {
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size = 0;
+    uint64_t resident = 0;
+    statm >> size >> resident;
+    return resident * static_cast<uint64_t> (sysconf(_SC_PAGESIZE)) / 1024;
+}
+
+const std::string& payload_body(const std::string& name) {
+    static std::string small = SMALL_JSON;
+    static std::string one_mb = std::string(1 << 20, 'x');
+    if ("small" == name) {
+        return small;
+    } else if ("1m" == name) {
+        return one_mb;
+    }
+    throw sl::support::exception(TRACEMSG("Invalid payload: [" + name + "]"));
+}
+
+void run_server(const bench_config& conf) {
+    sl::pion::http_server server(2, TCP_PORT);
+    for (auto& name : conf.payloads) {
+        auto& body = payload_body(name);
+        server.add_handler("GET", "/" + name, [&body](sl::pion::http_request_ptr, sl::pion::response_writer_ptr resp) {
+            resp->write(body);
+            resp->send(std::move(resp));
+        });
+    }
+    server.start();
+    // killed by parent
+    for (;;) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+}
+
+void read_to_eof(sl::http::resource& res, std::array<char, 65536>& buf) {
+    for (;;) {
+        auto read = res.read({buf.data(), buf.size()});
+        if (std::char_traits<char>::eof() == read) break;
+    }
+    if (!res.connection_successful() || 200 != res.get_status_code()) {
+        throw sl::support::exception(TRACEMSG("Request failed, url: [" + res.get_url() + "]," +
+                " error: [" + res.get_error() + "]"));
+    }
+}
+
+void run_requests(sl::http::session& session, bool polling, const std::string& url,
+        uint32_t count, std::array<char, 65536>& buf) {
+    auto opts = sl::http::request_options();
+    opts.method = "GET";
+    // reused between requests
+    auto vec = std::vector<sl::http::resource>();
+    for (uint32_t i = 0; i < count; i++) {
+        auto res = session.open_url(url, opts);
+        if (polling) {
+            auto& ps = static_cast<sl::http::polling_session&> (session);
+            vec.clear();
+            while (vec.empty()) {
+                ps.poll(1000, 1, vec);
+            }
+            read_to_eof(vec.front(), buf);
+        } else {
+            read_to_eof(res, buf);
+        }
+    }
+}
+
+bool run_case(const bench_config& conf, const std::string& session_name, const std::string& payload) {
+    auto url = "http://127.0.0.1:" + sl::support::to_string(TCP_PORT) + "/" + payload;
+    auto buf = std::array<char, 65536>();
+    auto rss_start = rss_kb();
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+    {
+        std::unique_ptr<sl::http::session> session;
+        bool polling = false;
+        if ("single" == session_name) {
+            session.reset(new sl::http::single_threaded_session());
+        } else if ("multi" == session_name) {
+            session.reset(new sl::http::multi_threaded_session());
+        } else if ("polling" == session_name) {
+            session.reset(new sl::http::polling_session());
+            polling = true;
+        } else {
+            throw sl::support::exception(TRACEMSG("Invalid session: [" + session_name + "]"));
+        }
+        // connections and caches are set up here
+        run_requests(*session, polling, url, WARMUP_REQUESTS, buf);
+        auto count_start = allocs_count.load(std::memory_order_relaxed);
+        auto bytes_start = allocs_bytes.load(std::memory_order_relaxed);
+        run_requests(*session, polling, url, conf.requests, buf);
+        count = allocs_count.load(std::memory_order_relaxed) - count_start;
+        bytes = allocs_bytes.load(std::memory_order_relaxed) - bytes_start;
+    }
+    auto rss_end = rss_kb();
+    auto allocs_per_req = count / conf.requests;
+    auto bytes_per_req = bytes / conf.requests;
+    bool within_budget = (0 == conf.budget_allocs || allocs_per_req <= conf.budget_allocs) &&
+            (0 == conf.budget_bytes || bytes_per_req <= conf.budget_bytes);
+    std::cout << session_name << "," << payload << "," << conf.requests << ","
+            << allocs_per_req << "," << bytes_per_req << ","
+            << rss_start << "," << rss_end << ","
+            << (rss_end > rss_start ? rss_end - rss_start : 0) << ","
+            << (within_budget ? "ok" : "exceeded") << std::endl;
+    return within_budget;
+}
+
+std::vector<std::string> split_list(const std::string& str) {
+    auto res = std::vector<std::string>();
+    size_t start = 0;
+    for (;;) {
+        auto pos = str.find(',', start);
+        res.push_back(str.substr(start, std::string::npos == pos ? pos : pos - start));
+        if (std::string::npos == pos) break;
+        start = pos + 1;
+    }
+    return res;
+}
+
+bench_config parse_args(int argc, char** argv) {
+    auto conf = bench_config();
+    for (int i = 1; i < argc; i++) {
+        auto arg = std::string(argv[i]);
+        auto eq = arg.find('=');
+        if (std::string::npos == eq) throw sl::support::exception(TRACEMSG(
+                "Invalid argument: [" + arg + "], expected 'name=value'"));
+        auto name = arg.substr(0, eq);
+        auto value = arg.substr(eq + 1);
+        if ("sessions" == name) {
+            conf.sessions = split_list(value);
+        } else if ("payloads" == name) {
+            conf.payloads = split_list(value);
+        } else if ("requests" == name) {
+            conf.requests = static_cast<uint32_t> (std::stoul(value));
+        } else if ("budget_allocs" == name) {
+            conf.budget_allocs = static_cast<uint64_t> (std::stoull(value));
+        } else if ("budget_bytes" == name) {
+            conf.budget_bytes = static_cast<uint64_t> (std::stoull(value));
+        } else {
+            throw sl::support::exception(TRACEMSG("Invalid argument name: [" + name + "]"));
+        }
+    }
+    if (0 == conf.requests) throw sl::support::exception(TRACEMSG("Invalid zero 'requests' argument"));
+    return conf;
+}
+
+void wait_for_server() {
+    auto opts = sl::http::request_options();
+    opts.abort_on_connect_error = false;
+    opts.abort_on_response_error = false;
+    auto url = "http://127.0.0.1:" + sl::support::to_string(TCP_PORT) + "/";
+    for (int i = 0; i < 100; i++) {
+        try {
+            auto session = sl::http::single_threaded_session();
+            auto res = session.open_url(url, opts);
+            auto buf = std::array<char, 1024>();
+            while (std::char_traits<char>::eof() != res.read({buf.data(), buf.size()})) { }
+            if (res.get_status_code() > 0) {
+                return;
+            }
+        } catch (const std::exception&) {
+            // not yet started
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    throw sl::support::exception(TRACEMSG("Server start timeout"));
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+    count_alloc(size);
+    void* res = std::malloc(0 != size ? size : 1);
+    if (nullptr == res) {
+        throw std::bad_alloc();
+    }
+    return res;
+}
+
+void operator delete(void* ptr) STATICLIB_NOEXCEPT {
+    std::free(ptr);
+}
+
+int main(int argc, char** argv) {
+    pid_t server_pid = -1;
+    try {
+        auto conf = parse_args(argc, argv);
+        // must be forked before any threads are started
+        server_pid = fork();
+        if (-1 == server_pid) throw sl::support::exception(TRACEMSG("Server fork error"));
+        if (0 == server_pid) {
+            run_server(conf);
+            return 0;
+        }
+        curl_global_init_mem(CURL_GLOBAL_ALL, curl_malloc_cb, curl_free_cb,
+                curl_realloc_cb, curl_strdup_cb, curl_calloc_cb);
+        wait_for_server();
+        std::cout << "session,payload,requests,allocs_per_req,bytes_per_req,"
+                << "rss_start_kb,rss_end_kb,rss_growth_kb,budget" << std::endl;
+        bool success = true;
+        for (auto& session : conf.sessions) {
+            for (auto& payload : conf.payloads) {
+                success = run_case(conf, session, payload) && success;
+            }
+        }
+        kill(server_pid, SIGTERM);
+        waitpid(server_pid, nullptr, 0);
+        curl_global_cleanup();
+        return success ? 0 : 2;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        if (server_pid > 0) {
+            kill(server_pid, SIGTERM);
+            waitpid(server_pid, nullptr, 0);
+        }
+        return 1;
+    }
+}
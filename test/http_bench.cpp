@@ -0,0 +1,450 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   http_bench.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 5:40 PM
+ */
+
+// Loopback macro-benchmark, starts local HTTP and HTTPS servers
+// and runs the matrix of {session} x {method} x {payload} x {scheme} x {concurrency},
+// results are written to stdout as CSV.
+//
+// Usage (from the build directory):
+//
+//     ./staticlib_http_bench [sessions=single,multi,polling] [methods=get]
+//             [payloads=small,1m] [schemes=http,https] [concurrency=1,8,64] [requests=1000]
+//
+// For 'post' method payload is sent as a request body (with "Content-Length"),
+// 'post_expect' does the same with "Expect: 100-continue" allowed, the server
+// does not answer "100 Continue", so the difference shows the stall time.
+// cURL adds this header only to large enough bodies (over 1 KB in older
+// versions), use 'payloads=8k' to see the stall on small POSTs.
+//
+// 1g payload is not included by default, server keeps
+// the whole body in memory, so it requires a few GB of RAM.
+// CPU time is a process time and includes the in-process server.
+
+#include <cstdint>
+#include <ctime>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "asio.hpp"
+
+#include "staticlib/pion.hpp"
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/http.hpp"
+
+namespace { // anonymous
+
+const uint16_t HTTP_PORT = 8080;
+const uint16_t HTTPS_PORT = 8443;
+const std::string SERVER_CERT_PATH = "../test/certificates/server/localhost.pem";
+const std::string CLIENT_CERT_PATH = "../test/certificates/client/testclient.pem";
+const std::string CA_PATH = "../test/certificates/server/staticlibs_test_ca.cer";
+
+const std::string SMALL_JSON = "{\"id\": 42, \"name\": \"staticlib_http\", \"tags\": [\"bench\", \"loopback\"]}";
+
+struct bench_config {
+    std::vector<std::string> sessions = {"single", "multi", "polling"};
+    std::vector<std::string> methods = {"get"};
+    std::vector<std::string> payloads = {"small", "1m"};
+    std::vector<std::string> schemes = {"http", "https"};
+    std::vector<uint32_t> concurrency = {1, 8, 64};
+    uint32_t requests = 1000;
+};
+
+struct cell_result {
+    uint32_t completed = 0;
+    uint32_t errors = 0;
+    uint64_t bytes = 0;
+    std::vector<uint64_t> latencies_micros;
+};
+
+std::string pwdcb(std::size_t, asio::ssl::context::password_purpose) {
+    return "test";
+}
+
+bool verifier(bool, asio::ssl::verify_context&) {
+    return true;
+}
+
+const std::string& payload_body(const std::string& name) {
+    static std::string small = SMALL_JSON;
+    static std::string eight_kb = std::string(8 << 10, 'x');
+    static std::string one_mb = std::string(1 << 20, 'x');
+    if ("small" == name) {
+        return small;
+    } else if ("8k" == name) {
+        return eight_kb;
+    } else if ("1m" == name) {
+        return one_mb;
+    } else if ("1g" == name) {
+        static std::string one_gb = std::string(1 << 30, 'x');
+        return one_gb;
+    }
+    throw sl::support::exception(TRACEMSG("Invalid payload: [" + name + "]"));
+}
+
+void add_handlers(sl::pion::http_server& server, const bench_config& conf) {
+    server.add_handler("POST", "/post", [](sl::pion::http_request_ptr, sl::pion::response_writer_ptr resp) {
+        resp->write(SMALL_JSON);
+        resp->send(std::move(resp));
+    });
+    for (auto& name : conf.payloads) {
+        // allocate before starting the server
+        auto& body = payload_body(name);
+        server.add_handler("GET", "/" + name, [&body](sl::pion::http_request_ptr, sl::pion::response_writer_ptr resp) {
+            resp->write(body);
+            resp->send(std::move(resp));
+        });
+    }
+}
+
+sl::http::request_options make_options(const std::string& method, const std::string& scheme) {
+    auto opts = sl::http::request_options();
+    if ("get" == method) {
+        opts.method = "GET";
+    } else if ("post" == method || "post_expect" == method) {
+        opts.method = "POST";
+        opts.send_expect_100_continue = "post_expect" == method;
+    } else {
+        throw sl::support::exception(TRACEMSG("Invalid method: [" + method + "]"));
+    }
+    // single-threaded session treats zero as an immediate timeout
+    opts.timeout_millis = 600000;
+    opts.buffersize_bytes = 1 << 16;
+    if ("https" == scheme) {
+        opts.sslcert_filename = CLIENT_CERT_PATH;
+        opts.sslcertype = "PEM";
+        opts.sslkey_filename = CLIENT_CERT_PATH;
+        opts.ssl_key_type = "PEM";
+        opts.ssl_keypasswd = "test";
+    }
+    return opts;
+}
+
+std::string make_url(const std::string& method, const std::string& scheme, const std::string& payload) {
+    auto port = "https" == scheme ? HTTPS_PORT : HTTP_PORT;
+    auto path = "get" == method ? payload : std::string("post");
+    return scheme + "://127.0.0.1:" + sl::support::to_string(port) + "/" + path;
+}
+
+sl::http::request_body make_body(const std::string& method, const std::string& payload) {
+    if ("get" == method) {
+        return sl::http::request_body();
+    }
+    auto& body = payload_body(payload);
+    return sl::http::request_body(sl::io::span<const char>(body.data(), body.size()));
+}
+
+sl::http::resource open_resource(sl::http::session& session, const std::string& url,
+        const sl::http::request_body& body, const sl::http::request_options& opts) {
+    if (body.is_present()) {
+        return session.open_url(url, body, opts);
+    }
+    return session.open_url(url, opts);
+}
+
+uint64_t now_micros() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t> (std::chrono::duration_cast<std::chrono::microseconds>(now).count());
+}
+
+// returns number of bytes read, or -1 on error,
+// single-threaded resources return 0 while waiting for data
+int64_t drain_some(sl::http::resource& res, std::array<char, 65536>& buf) {
+    auto read = res.read({buf.data(), buf.size()});
+    if (std::char_traits<char>::eof() == read) {
+        return -1;
+    }
+    return static_cast<int64_t> (read);
+}
+
+void record_finished(cell_result& cr, sl::http::resource& res, uint64_t bytes, uint64_t started) {
+    cr.latencies_micros.push_back(now_micros() - started);
+    if (res.connection_successful() && 200 == res.get_status_code() && res.get_error().empty()) {
+        cr.completed += 1;
+        cr.bytes += bytes;
+    } else {
+        cr.errors += 1;
+    }
+}
+
+void record_failed(cell_result& cr, uint64_t started) {
+    cr.latencies_micros.push_back(now_micros() - started);
+    cr.errors += 1;
+}
+
+// opens 'concurrency' resources and reads them round-robin,
+// single-threaded session allows only one open resource,
+// so every in-flight request gets its own session
+void run_single(const bench_config& conf, const std::string& url, const sl::http::request_body& body,
+        const sl::http::request_options& opts, uint32_t concurrency, cell_result& cr) {
+    struct in_flight {
+        // must outlive the resource
+        std::unique_ptr<sl::http::single_threaded_session> session;
+        sl::http::resource res;
+        uint64_t started;
+        uint64_t bytes;
+    };
+    auto buf = std::array<char, 65536>();
+    auto active = std::vector<in_flight>();
+    uint32_t submitted = 0;
+    while (submitted < conf.requests || !active.empty()) {
+        while (submitted < conf.requests && active.size() < concurrency) {
+            auto started = now_micros();
+            submitted += 1;
+            auto session = sl::support::make_unique<sl::http::single_threaded_session>();
+            try {
+                auto res = open_resource(*session, url, body, opts);
+                active.push_back({std::move(session), std::move(res), started, 0});
+            } catch (const std::exception&) {
+                record_failed(cr, started);
+            }
+        }
+        for (size_t i = 0; i < active.size();) {
+            auto& en = active[i];
+            try {
+                auto read = drain_some(en.res, buf);
+                if (read >= 0) {
+                    en.bytes += static_cast<uint64_t> (read);
+                    i += 1;
+                    continue;
+                }
+                record_finished(cr, en.res, en.bytes, en.started);
+            } catch (const std::exception&) {
+                record_failed(cr, en.started);
+            }
+            active.erase(active.begin() + static_cast<std::ptrdiff_t> (i));
+        }
+    }
+}
+
+// every consumer thread reads its requests sequentially
+void run_multi(const bench_config& conf, const std::string& url, const sl::http::request_body& body,
+        const sl::http::request_options& opts, uint32_t concurrency, cell_result& cr) {
+    auto session = sl::http::multi_threaded_session();
+    std::atomic<uint32_t> counter{0};
+    std::mutex mutex;
+    auto threads = std::vector<std::thread>();
+    for (uint32_t t = 0; t < concurrency; t++) {
+        threads.emplace_back([&] {
+            auto buf = std::array<char, 65536>();
+            auto local = cell_result();
+            while (counter.fetch_add(1, std::memory_order_relaxed) < conf.requests) {
+                auto started = now_micros();
+                try {
+                    auto res = open_resource(session, url, body, opts);
+                    uint64_t bytes = 0;
+                    for (;;) {
+                        auto read = drain_some(res, buf);
+                        if (read < 0) break;
+                        bytes += static_cast<uint64_t> (read);
+                    }
+                    record_finished(local, res, bytes, started);
+                } catch (const std::exception&) {
+                    record_failed(local, started);
+                }
+            }
+            std::lock_guard<std::mutex> guard{mutex};
+            cr.completed += local.completed;
+            cr.errors += local.errors;
+            cr.bytes += local.bytes;
+            cr.latencies_micros.insert(cr.latencies_micros.end(),
+                    local.latencies_micros.begin(), local.latencies_micros.end());
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+}
+
+// keeps 'concurrency' requests enqueued
+void run_polling(const bench_config& conf, const std::string& url, const sl::http::request_body& body,
+        const sl::http::request_options& opts, uint32_t concurrency, cell_result& cr) {
+    auto session = sl::http::polling_session();
+    auto buf = std::array<char, 65536>();
+    auto started = std::map<uint64_t, uint64_t>();
+    uint32_t submitted = 0;
+    while (submitted < conf.requests || !started.empty()) {
+        while (submitted < conf.requests && started.size() < concurrency) {
+            auto ts = now_micros();
+            auto res = open_resource(session, url, body, opts);
+            started.insert(std::make_pair(res.get_id(), ts));
+            submitted += 1;
+        }
+        auto finished = session.poll();
+        for (auto& res : finished) {
+            uint64_t bytes = 0;
+            for (;;) {
+                auto read = drain_some(res, buf);
+                if (read < 0) break;
+                bytes += static_cast<uint64_t> (read);
+            }
+            auto it = started.find(res.get_id());
+            slassert(started.end() != it);
+            record_finished(cr, res, bytes, it->second);
+            started.erase(it);
+        }
+    }
+}
+
+uint64_t percentile(const std::vector<uint64_t>& sorted, double pct) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    auto idx = static_cast<size_t> (static_cast<double> (sorted.size() - 1) * pct / 100);
+    return sorted[idx];
+}
+
+std::string fixed2(double val) {
+    auto scaled = static_cast<uint64_t> (val * 100 + 0.5);
+    auto frac = sl::support::to_string(scaled % 100);
+    return sl::support::to_string(scaled / 100) + "." + (frac.length() < 2 ? "0" : "") + frac;
+}
+
+void run_cell(const bench_config& conf, const std::string& session, const std::string& method,
+        const std::string& payload, const std::string& scheme, uint32_t concurrency) {
+    auto url = make_url(method, scheme, payload);
+    auto body = make_body(method, payload);
+    auto opts = make_options(method, scheme);
+    auto cr = cell_result();
+    cr.latencies_micros.reserve(conf.requests);
+    auto cpu_start = std::clock();
+    auto wall_start = now_micros();
+    if ("single" == session) {
+        run_single(conf, url, body, opts, concurrency, cr);
+    } else if ("multi" == session) {
+        run_multi(conf, url, body, opts, concurrency, cr);
+    } else if ("polling" == session) {
+        run_polling(conf, url, body, opts, concurrency, cr);
+    } else {
+        throw sl::support::exception(TRACEMSG("Invalid session: [" + session + "]"));
+    }
+    auto wall_micros = now_micros() - wall_start;
+    auto cpu_micros = static_cast<double> (std::clock() - cpu_start) * 1000000 / CLOCKS_PER_SEC;
+    std::sort(cr.latencies_micros.begin(), cr.latencies_micros.end());
+    double secs = static_cast<double> (wall_micros > 0 ? wall_micros : 1) / 1000000;
+    uint32_t total = cr.completed + cr.errors;
+    std::cout << session << "," << method << "," << payload << "," << scheme << "," << concurrency << ","
+            << cr.completed << "," << cr.errors << ","
+            << fixed2(cr.completed / secs) << ","
+            << fixed2(static_cast<double> (cr.bytes) / (1 << 20) / secs) << ","
+            << percentile(cr.latencies_micros, 50) << ","
+            << percentile(cr.latencies_micros, 99) << ","
+            << percentile(cr.latencies_micros, 99.9) << ","
+            << fixed2(total > 0 ? cpu_micros / total : 0) << std::endl;
+}
+
+std::vector<std::string> split_list(const std::string& str) {
+    auto res = std::vector<std::string>();
+    size_t start = 0;
+    for (;;) {
+        auto pos = str.find(',', start);
+        res.push_back(str.substr(start, std::string::npos == pos ? pos : pos - start));
+        if (std::string::npos == pos) break;
+        start = pos + 1;
+    }
+    return res;
+}
+
+bench_config parse_args(int argc, char** argv) {
+    auto conf = bench_config();
+    for (int i = 1; i < argc; i++) {
+        auto arg = std::string(argv[i]);
+        auto eq = arg.find('=');
+        if (std::string::npos == eq) throw sl::support::exception(TRACEMSG(
+                "Invalid argument: [" + arg + "], expected 'name=value'"));
+        auto name = arg.substr(0, eq);
+        auto value = arg.substr(eq + 1);
+        if ("sessions" == name) {
+            conf.sessions = split_list(value);
+        } else if ("methods" == name) {
+            conf.methods = split_list(value);
+        } else if ("payloads" == name) {
+            conf.payloads = split_list(value);
+        } else if ("schemes" == name) {
+            conf.schemes = split_list(value);
+        } else if ("concurrency" == name) {
+            conf.concurrency.clear();
+            for (auto& st : split_list(value)) {
+                conf.concurrency.push_back(static_cast<uint32_t> (std::stoul(st)));
+            }
+        } else if ("requests" == name) {
+            conf.requests = static_cast<uint32_t> (std::stoul(value));
+        } else {
+            throw sl::support::exception(TRACEMSG("Invalid argument name: [" + name + "]"));
+        }
+    }
+    return conf;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        auto conf = parse_args(argc, argv);
+        sl::pion::http_server http_server(4, HTTP_PORT);
+        sl::pion::http_server https_server(4, HTTPS_PORT, asio::ip::address_v4::any(), 10000,
+                SERVER_CERT_PATH, pwdcb, CA_PATH, verifier);
+        add_handlers(http_server, conf);
+        add_handlers(https_server, conf);
+        http_server.start();
+        https_server.start();
+        std::cout << "session,method,payload,scheme,concurrency,completed,errors,"
+                << "req_per_sec,mb_per_sec,p50_us,p99_us,p999_us,cpu_us_per_req" << std::endl;
+        try {
+            for (auto& session : conf.sessions) {
+                for (auto& method : conf.methods) {
+                    for (auto& payload : conf.payloads) {
+                        for (auto& scheme : conf.schemes) {
+                            for (auto concurrency : conf.concurrency) {
+                                run_cell(conf, session, method, payload, scheme, concurrency);
+                            }
+                        }
+                    }
+                }
+            }
+        } catch (const std::exception&) {
+            http_server.stop(true);
+            https_server.stop(true);
+            throw;
+        }
+        http_server.stop(true);
+        https_server.stop(true);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
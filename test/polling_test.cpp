@@ -24,9 +24,15 @@
 #include "staticlib/http/resource.hpp"
 
 #include <cstdint>
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
 #include <thread>
 
@@ -38,8 +44,12 @@
 #include "staticlib/io.hpp"
 #include "staticlib/tinydir.hpp"
 
+#include "staticlib/http/parallel_download.hpp"
+#include "staticlib/http/parallel_upload.hpp"
 #include "staticlib/http/polling_session.hpp"
 
+#include "raw_http_server.hpp"
+
 const uint16_t TCP_PORT = 8443;
 const std::string URL = std::string() + "https://127.0.0.1:" + sl::support::to_string(TCP_PORT) + "/";
 const std::string GET_RESPONSE = "Hello from GET\n";
@@ -50,6 +60,8 @@ const std::string DELETE_RESPONSE = "Hello from DELETE\n";
 const std::string SERVER_CERT_PATH = "../test/certificates/server/localhost.pem";
 const std::string CLIENT_CERT_PATH = "../test/certificates/client/testclient.pem";
 const std::string CA_PATH = "../test/certificates/server/staticlibs_test_ca.cer";
+const uint16_t RAW_TCP_PORT = 8081;
+const std::string RAW_URL = std::string() + "http://127.0.0.1:" + sl::support::to_string(RAW_TCP_PORT) + "/";
 
 std::string pwdcb(std::size_t, asio::ssl::context::password_purpose) {
     return "test";
@@ -103,6 +115,7 @@ void enqueue_get(sl::http::polling_session& session) {
     opts.headers = {{"User-Agent", "test"}, {"X-Method", "GET"}};
     enrich_opts_ssl(opts);
     opts.method = "GET";
+    opts.record_timeline = true;
     sl::http::resource src = session.open_url(URL + "get", opts);
 
     // check empty
@@ -118,6 +131,7 @@ void enqueue_post(sl::http::polling_session& session) {
     enrich_opts_ssl(opts);
     sl::io::string_source post_data{POSTPUT_DATA};
     opts.method = "POST";
+    opts.set_user_context(std::make_shared<std::string>("post"));
     sl::http::resource src = session.open_url(URL + "post", std::move(post_data), opts);
 
     // check empty
@@ -126,20 +140,20 @@ void enqueue_post(sl::http::polling_session& session) {
     slassert(empty.empty());
 }
 
+std::string pattern_data(size_t len) {
+    auto res = std::string();
+    res.resize(len);
+    for (size_t i = 0; i < len; i++) {
+        res[i] = static_cast<char> ('a' + (i * 31) % 26);
+    }
+    return res;
+}
+
 std::vector<sl::http::resource> poll(sl::http::polling_session& session,
         uint32_t count, uint32_t max_count) {
     auto vec = std::vector<sl::http::resource>();
-    for (uint32_t i = 0; i < max_count; i++) {
-        //auto start = std::chrono::system_clock::now();
-        auto completed = session.poll();
-        //auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start);
-        //std::cout << i << std::endl;
-        //std::cout << completed.size() << std::endl;
-        //std::cout << "millis elapsed: " << elapsed.count() << std::endl;
-        for (auto&& res : completed) {
-            vec.emplace_back(std::move(res));
-        }
-        if (vec.size() >= count) break;
+    for (uint32_t i = 0; i < max_count && vec.size() < count; i++) {
+        session.poll(100, count - vec.size(), vec);
     }
     return vec;
 }
@@ -170,6 +184,16 @@ void test_simple() {
             auto read = sl::io::read_all(res, data);
             slassert(GET_RESPONSE.length() == read);
             slassert(GET_RESPONSE == data);
+
+            // timeline
+            std::array<char, 1> tail;
+            slassert(std::char_traits<char>::eof() == res.read(tail));
+            auto tl = res.get_timeline();
+            slassert(tl.submitted > 0);
+            slassert(tl.first_header >= tl.submitted);
+            slassert(tl.first_byte >= tl.first_header);
+            slassert(tl.completed >= tl.first_byte);
+            slassert(tl.consumer_eof >= tl.completed);
         }
 
         { // post
@@ -181,11 +205,38 @@ void test_simple() {
             auto res = std::move(vec.at(0));
             slassert(200 == res.get_status_code());
             slassert(sl::support::to_string(POST_RESPONSE.length()) == res.get_header("Content-Length"));
+            slassert("post" == *res.get_user_context<std::string>());
+            bool threw = false;
+            try {
+                res.get_user_context<int>();
+            } catch (const sl::http::http_exception&) {
+                threw = true;
+            }
+            slassert(threw);
+            auto view = res.body_view();
+            slassert(POST_RESPONSE == std::string(view.data(), view.size()));
             auto data = std::string();
             data.resize(POST_RESPONSE.length());
             auto read = sl::io::read_all(res, data);
             slassert(POST_RESPONSE.length() == read);
             slassert(POST_RESPONSE == data);
+            auto body = res.take_body();
+            slassert(POST_RESPONSE == std::string(body.data(), body.size()));
+            slassert(0 == res.body_view().size());
+        }
+
+        { // metrics
+            auto mx = session.get_metrics();
+            slassert(2 == mx.requests_submitted);
+            slassert(2 == mx.requests_completed);
+            slassert(0 == mx.requests_in_flight);
+            slassert(2 == mx.total_time.count);
+            slassert(mx.total_time.percentile_micros(99) > 0);
+            // at least one connection is made, it may be reused by the second request
+            slassert(mx.new_connections >= 1 && mx.new_connections <= 2);
+            auto text = sl::http::metrics_to_prometheus_text(mx);
+            slassert(std::string::npos != text.find("staticlib_http_requests_completed_total 2"));
+            slassert(std::string::npos != text.find("staticlib_http_new_connections_total"));
         }
 
     } catch (const std::exception&) {
@@ -244,10 +295,570 @@ void test_parallel() {
     server.stop(true);
 }
 
+std::mutex upload_parts_mutex;
+std::map<uint32_t, std::string> upload_parts;
+
+class part_receiver {
+    std::string data;
+public:
+    void operator()(const char* s, size_t n) {
+        data.append(s, n);
+    }
+
+    const std::string& get_data() {
+        return data;
+    }
+};
+
+void part_handler(sl::pion::http_request_ptr req, sl::pion::response_writer_ptr resp) {
+    auto ph = req->get_payload_handler<part_receiver>();
+    slassert(nullptr != ph);
+    auto idx = static_cast<uint32_t> (std::stoul(req->get_header("X-Part-Index")));
+    {
+        std::lock_guard<std::mutex> guard{upload_parts_mutex};
+        upload_parts[idx] = ph->get_data();
+    }
+    resp->write("OK");
+    resp->send(std::move(resp));
+}
+
+void test_parallel_upload() {
+    // server
+    sl::pion::http_server server(2, TCP_PORT, asio::ip::address_v4::any(), 10000, SERVER_CERT_PATH, pwdcb, CA_PATH, verifier);
+    server.add_handler("PUT", "/part", part_handler);
+    server.add_payload_handler("PUT", "/part", [](sl::pion::http_request_ptr&) { return part_receiver{}; });
+    server.start();
+    try {
+        auto data = std::string();
+        for (size_t i = 0; data.length() < 10500; i++) {
+            data.append(sl::support::to_string(i)).append(" ");
+        }
+        auto session = sl::http::polling_session();
+        auto job = sl::http::parallel_upload(session, sl::http::request_body({data.data(), data.length()}),
+                1000, 4, [](const sl::http::upload_part& part) {
+            auto target = sl::http::upload_part_target();
+            target.url = URL + "part";
+            enrich_opts_ssl(target.options);
+            target.options.dynamic_headers.emplace_back("X-Part-Index", sl::support::to_string(part.index));
+            return target;
+        });
+        auto results = job.run();
+        slassert(11 == results.size());
+        for (auto& pr : results) {
+            slassert(pr.success);
+            slassert(1 == pr.attempts);
+            slassert(200 == pr.status_code);
+        }
+        // reassemble
+        auto assembled = std::string();
+        std::lock_guard<std::mutex> guard{upload_parts_mutex};
+        slassert(11 == upload_parts.size());
+        for (auto& pa : upload_parts) {
+            assembled.append(pa.second);
+        }
+        slassert(data == assembled);
+    } catch (const std::exception&) {
+        server.stop(true);
+        throw;
+    }
+    // stop server
+    server.stop(true);
+}
+
+void test_parallel_upload_retry() {
+    // part 2 fails once and asks to retry after 1 second
+    auto data = pattern_data(10000);
+    std::atomic<bool> failed{false};
+    raw_http_server server(RAW_TCP_PORT, [&failed](const raw_http_request& req) {
+        if ("2" == req.header("X-Part-Index") && !failed.exchange(true)) {
+            return raw_http_server::response("503 Service Unavailable", {{"Retry-After", "1"}}, "");
+        }
+        return raw_http_server::response("200 OK", {}, "OK");
+    });
+    auto session = sl::http::polling_session();
+    auto job = sl::http::parallel_upload(session, sl::http::request_body({data.data(), data.length()}),
+            1000, 4, [](const sl::http::upload_part& part) {
+        auto target = sl::http::upload_part_target();
+        target.url = RAW_URL + "part";
+        target.options.dynamic_headers.emplace_back("X-Part-Index", sl::support::to_string(part.index));
+        return target;
+    });
+    auto start = std::chrono::steady_clock::now();
+    auto results = job.run();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    slassert(10 == results.size());
+    for (auto& pr : results) {
+        slassert(pr.success);
+        slassert(200 == pr.status_code);
+        slassert((2 == pr.part.index ? 2 : 1) == pr.attempts);
+    }
+    slassert(elapsed >= std::chrono::seconds(1));
+    // both attempts sent the same part
+    auto attempts = std::vector<std::string>();
+    for (auto& req : server.received()) {
+        if ("2" == req.header("X-Part-Index")) {
+            attempts.push_back(req.body);
+        }
+    }
+    slassert(2 == attempts.size());
+    slassert(data.substr(2000, 1000) == attempts.front());
+    slassert(attempts.front() == attempts.back());
+}
+
+void test_parallel_download_fallback() {
+    // server, no HEAD handler, job falls back to a single GET
+    sl::pion::http_server server(2, TCP_PORT, asio::ip::address_v4::any(), 10000, SERVER_CERT_PATH, pwdcb, CA_PATH, verifier);
+    server.add_handler("GET", "/get", get_handler);
+    server.start();
+    auto path = std::string("polling_test_download.txt");
+    try {
+        auto opts = sl::http::request_options();
+        enrich_opts_ssl(opts);
+        opts.headers.emplace_back("User-Agent", "test");
+        opts.headers.emplace_back("X-Method", "GET");
+        // second session writes files from writer threads
+        auto async_sopts = sl::http::session_options();
+        async_sopts.polling_file_writer_threads = 2;
+        for (auto& sopts : {sl::http::session_options(), async_sopts}) {
+            auto session = sl::http::polling_session(sopts);
+            opts.polling_response_body_file_sync = sopts.polling_file_writer_threads > 0;
+            auto progress_calls = 0;
+            auto job = sl::http::parallel_download(session, URL + "get", path, 4, 4, opts, 3,
+                    [&progress_calls](const sl::http::download_segment_result&) {
+                progress_calls += 1;
+            });
+            auto results = job.run();
+            slassert(1 == results.size());
+            slassert(1 == progress_calls);
+            auto& sr = results.front();
+            slassert(sr.success);
+            slassert(1 == sr.attempts);
+            slassert(200 == sr.status_code);
+            slassert(GET_RESPONSE.length() == sr.segment.length);
+            auto src = sl::tinydir::file_source(path);
+            auto sink = sl::io::string_sink();
+            sl::io::copy_all(src, sink);
+            slassert(GET_RESPONSE == sink.get_string());
+        }
+    } catch (const std::exception&) {
+        server.stop(true);
+        sl::tinydir::path(path).remove_quietly();
+        throw;
+    }
+    // stop server
+    server.stop(true);
+    sl::tinydir::path(path).remove_quietly();
+}
+
+void test_parallel_download_ranges() {
+    auto body = pattern_data((100 << 10) + 7);
+    raw_http_server server(RAW_TCP_PORT, [&body](const raw_http_request& req) {
+        auto size = sl::support::to_string(body.length());
+        if ("HEAD" == req.method) {
+            return raw_http_server::response("200 OK", {
+                {"Accept-Ranges", "bytes"},
+                {"Content-Length", size}
+            }, "", false);
+        }
+        auto range = req.header("Range");
+        slassert(0 == range.find("bytes="));
+        auto dash = range.find('-');
+        auto first = static_cast<size_t> (std::stoull(range.substr(6, dash - 6)));
+        auto last = static_cast<size_t> (std::stoull(range.substr(dash + 1)));
+        return raw_http_server::response("206 Partial Content", {
+            {"Content-Range", "bytes " + sl::support::to_string(first) + "-" +
+                    sl::support::to_string(last) + "/" + size}
+        }, body.substr(first, last - first + 1));
+    });
+    auto path = std::string("polling_test_download_ranges.bin");
+    try {
+        auto session = sl::http::polling_session();
+        auto opts = sl::http::request_options();
+        auto job = sl::http::parallel_download(session, RAW_URL + "ranges", path, 16 << 10, 3, opts, 1);
+        auto results = job.run();
+        slassert(7 == results.size());
+        for (auto& sr : results) {
+            slassert(sr.success);
+            slassert(1 == sr.attempts);
+            slassert(206 == sr.status_code);
+        }
+        auto reqs = server.received();
+        slassert(8 == reqs.size());
+        slassert("HEAD" == reqs.front().method);
+        for (auto& req : reqs) {
+            // ranges are offsets in the identity representation
+            slassert(!req.has_header("Accept-Encoding"));
+        }
+        auto src = sl::tinydir::file_source(path);
+        auto sink = sl::io::string_sink();
+        sl::io::copy_all(src, sink);
+        slassert(body == sink.get_string());
+    } catch (const std::exception&) {
+        sl::tinydir::path(path).remove_quietly();
+        throw;
+    }
+    sl::tinydir::path(path).remove_quietly();
+}
+
+void test_parallel_download_range_ignored() {
+    // segment 2 gets a full "200" response with different content
+    auto body = pattern_data(64 << 10);
+    raw_http_server server(RAW_TCP_PORT, [&body](const raw_http_request& req) {
+        auto size = sl::support::to_string(body.length());
+        if ("HEAD" == req.method) {
+            return raw_http_server::response("200 OK", {
+                {"Accept-Ranges", "bytes"},
+                {"Content-Length", size}
+            }, "", false);
+        }
+        auto range = req.header("Range");
+        auto dash = range.find('-');
+        auto first = static_cast<size_t> (std::stoull(range.substr(6, dash - 6)));
+        auto last = static_cast<size_t> (std::stoull(range.substr(dash + 1)));
+        if (2 * (16 << 10) == first) {
+            return raw_http_server::response("200 OK", {}, std::string(body.length(), 'X'));
+        }
+        return raw_http_server::response("206 Partial Content", {
+            {"Content-Range", "bytes " + sl::support::to_string(first) + "-" +
+                    sl::support::to_string(last) + "/" + size}
+        }, body.substr(first, last - first + 1));
+    });
+    auto path = std::string("polling_test_download_range_ignored.bin");
+    try {
+        auto session = sl::http::polling_session();
+        auto job = sl::http::parallel_download(session, RAW_URL + "ranges", path, 16 << 10, 4,
+                sl::http::request_options(), 1);
+        auto results = job.run();
+        slassert(4 == results.size());
+        for (auto& sr : results) {
+            if (2 == sr.segment.index) {
+                slassert(!sr.success);
+                slassert(!sr.error.empty());
+            } else {
+                slassert(sr.success);
+            }
+        }
+        // other segments are not overwritten
+        auto src = sl::tinydir::file_source(path);
+        auto sink = sl::io::string_sink();
+        sl::io::copy_all(src, sink);
+        auto& data = sink.get_string();
+        slassert(body.length() == data.length());
+        slassert(std::string::npos == data.find('X'));
+        for (auto& sr : results) {
+            if (2 != sr.segment.index) {
+                auto off = static_cast<size_t> (sr.segment.offset);
+                auto len = static_cast<size_t> (sr.segment.length);
+                slassert(body.substr(off, len) == data.substr(off, len));
+            }
+        }
+    } catch (const std::exception&) {
+        sl::tinydir::path(path).remove_quietly();
+        throw;
+    }
+    sl::tinydir::path(path).remove_quietly();
+}
+
+void test_response_body_spill() {
+    auto small = pattern_data(1 << 10);
+    auto large = pattern_data(256 << 10);
+    raw_http_server server(RAW_TCP_PORT, [&small, &large](const raw_http_request& req) {
+        return raw_http_server::response("200 OK", {}, "/large" == req.path ? large : small);
+    });
+    auto session = sl::http::polling_session();
+    auto opts = sl::http::request_options();
+    opts.method = "GET";
+    opts.polling_response_body_spill_threshold_bytes = 16 << 10;
+    // moved to a temporary file
+    auto large_id = session.open_url(RAW_URL + "large", opts).get_id();
+    // kept in memory
+    auto small_id = session.open_url(RAW_URL + "small", opts).get_id();
+    auto vec = poll(session, 2, 1024);
+    slassert(2 == vec.size());
+    for (auto& res : vec) {
+        slassert(res.get_error().empty());
+        slassert(200 == res.get_status_code());
+        auto& expected = large_id == res.get_id() ? large : small;
+        slassert(large_id == res.get_id() || small_id == res.get_id());
+        auto view = res.body_view();
+        slassert(expected == std::string(view.data(), view.size()));
+        auto sink = sl::io::string_sink();
+        sl::io::copy_all(res, sink);
+        slassert(expected == sink.get_string());
+    }
+    // only the large body touches the spill directory
+    opts.polling_response_body_spill_dir = "polling_test_spill_nonexistent";
+    large_id = session.open_url(RAW_URL + "large", opts).get_id();
+    small_id = session.open_url(RAW_URL + "small", opts).get_id();
+    vec = poll(session, 2, 1024);
+    slassert(2 == vec.size());
+    for (auto& res : vec) {
+        if (large_id == res.get_id()) {
+            slassert(!res.get_error().empty());
+        } else {
+            slassert(res.get_error().empty());
+            auto view = res.body_view();
+            slassert(small == std::string(view.data(), view.size()));
+        }
+    }
+}
+
+void test_unsized_and_head() {
+    // no "Content-Length", body is collected in blocks
+    auto body = pattern_data((200 << 10) + 3);
+    raw_http_server server(RAW_TCP_PORT, [&body](const raw_http_request& req) {
+        if ("HEAD" == req.method) {
+            return raw_http_server::response("200 OK", {
+                {"Content-Length", sl::support::to_string(64 << 20)}
+            }, "", false);
+        }
+        auto chunked = std::string();
+        for (size_t pos = 0; pos < body.length(); pos += 10000) {
+            auto chunk = body.substr(pos, 10000);
+            std::ostringstream size;
+            size << std::hex << chunk.length();
+            chunked += size.str() + "\r\n" + chunk + "\r\n";
+        }
+        chunked += "0\r\n\r\n";
+        return raw_http_server::response("200 OK", {{"Transfer-Encoding", "chunked"}}, chunked, false);
+    });
+    auto session = sl::http::polling_session();
+    auto opts = sl::http::request_options();
+    opts.polling_response_body_spill_threshold_bytes = 1 << 20;
+    opts.method = "GET";
+    auto get_id = session.open_url(RAW_URL + "chunked", opts).get_id();
+    // body is not reserved for "Content-Length" of HEAD response
+    opts.method = "HEAD";
+    session.open_url(RAW_URL + "head", opts);
+    auto vec = poll(session, 2, 1024);
+    slassert(2 == vec.size());
+    for (auto& res : vec) {
+        slassert(res.get_error().empty());
+        slassert(200 == res.get_status_code());
+        auto view = res.body_view();
+        if (get_id == res.get_id()) {
+            slassert(body == std::string(view.data(), view.size()));
+            auto sink = sl::io::string_sink();
+            sl::io::copy_all(res, sink);
+            slassert(body == sink.get_string());
+        } else {
+            slassert(0 == view.size());
+        }
+    }
+}
+
+void test_streaming() {
+    // body is many times larger than the window, so the transfer is paused and resumed
+    auto body = pattern_data(256 << 10);
+    raw_http_server server(RAW_TCP_PORT, [&body](const raw_http_request&) {
+        return raw_http_server::response("200 OK", {}, body);
+    });
+    auto session = sl::http::polling_session();
+    auto opts = sl::http::request_options();
+    opts.method = "GET";
+    opts.record_timeline = true;
+    opts.polling_streaming = true;
+    opts.polling_streaming_window_bytes = 4096;
+    auto id = session.open_url(RAW_URL + "stream", opts).get_id();
+    // events cannot be dropped
+    bool thrown = false;
+    try {
+        session.poll();
+    } catch (const sl::http::http_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+    auto events = std::vector<sl::http::polling_event>();
+    auto finished = std::vector<sl::http::resource>();
+    for (uint32_t i = 0; i < 100000 && finished.empty(); i++) {
+        finished = session.poll(events);
+    }
+    slassert(1 == finished.size());
+    auto& res = finished.front();
+    slassert(id == res.get_id());
+    slassert(res.get_error().empty());
+    slassert(200 == res.get_status_code());
+    slassert(res.body_view().size() == 0);
+    slassert(res.get_timeline().pauses.size() > 0);
+    slassert(events.size() > 2);
+    slassert(sl::http::polling_event_type::headers_ready == events.front().type);
+    slassert(200 == events.front().status_code);
+    auto data = std::string();
+    for (size_t i = 1; i < events.size(); i++) {
+        auto& ev = events[i];
+        slassert(id == ev.resource_id);
+        slassert(sl::http::polling_event_type::data_available == ev.type);
+        data.append(ev.data.data(), ev.data.size());
+    }
+    slassert(body == data);
+    // no streaming requests left
+    slassert(session.poll().empty());
+}
+
+void test_submit_from_thread() {
+    const uint32_t count = 4;
+    sl::pion::http_server server(2, TCP_PORT, asio::ip::address_v4::any(), 10000, SERVER_CERT_PATH, pwdcb, CA_PATH, verifier);
+    server.add_handler("GET", "/get", get_handler);
+    server.start();
+    try {
+        auto session = sl::http::polling_session();
+        auto ids = std::vector<uint64_t>();
+        std::mutex mutex;
+        auto producer = std::thread([&session, &ids, &mutex] {
+            auto opts = sl::http::request_options();
+            enrich_opts_ssl(opts);
+            opts.headers = {{"User-Agent", "test"}, {"X-Method", "GET"}};
+            for (uint32_t i = 0; i < count; i++) {
+                auto res = session.submit_url(URL + "get", opts);
+                std::lock_guard<std::mutex> guard{mutex};
+                ids.push_back(res.get_id());
+            }
+        });
+        auto vec = poll(session, count, 1024);
+        producer.join();
+        slassert(count == vec.size());
+        for (auto& res : vec) {
+            slassert(200 == res.get_status_code());
+            slassert(ids.end() != std::find(ids.begin(), ids.end(), res.get_id()));
+            auto data = std::string();
+            data.resize(GET_RESPONSE.length());
+            auto read = sl::io::read_all(res, data);
+            slassert(GET_RESPONSE.length() == read);
+            slassert(GET_RESPONSE == data);
+        }
+    } catch (const std::exception&) {
+        server.stop(true);
+        throw;
+    }
+    // stop server
+    server.stop(true);
+}
+
+void test_file_writer_backpressure() {
+    // writer queue holds a single batch, so the transfer is paused on every batch
+    auto data = pattern_data(8 << 20);
+    raw_http_server server(RAW_TCP_PORT, [&data](const raw_http_request&) {
+        return raw_http_server::response("200 OK", {}, data);
+    });
+    auto path = std::string("polling_test_backpressure.bin");
+    try {
+        auto sopts = sl::http::session_options();
+        sopts.polling_file_writer_threads = 1;
+        sopts.polling_file_writer_max_queued_bytes = 1;
+        auto session = sl::http::polling_session(sopts);
+        auto opts = sl::http::request_options();
+        opts.method = "GET";
+        opts.record_timeline = true;
+        opts.polling_response_body_file_path = path;
+        session.open_url(RAW_URL + "large", opts);
+        auto vec = poll(session, 1, 1024);
+        slassert(1 == vec.size());
+        auto& res = vec.front();
+        slassert(res.get_error().empty());
+        slassert(200 == res.get_status_code());
+        auto tl = res.get_timeline();
+        slassert(tl.pauses.size() > 0);
+        for (auto& pa : tl.pauses) {
+            slassert(pa.second >= pa.first);
+        }
+        auto src = sl::tinydir::file_source(path);
+        auto sink = sl::io::string_sink();
+        sl::io::copy_all(src, sink);
+        slassert(data == sink.get_string());
+    } catch (const std::exception&) {
+        sl::tinydir::path(path).remove_quietly();
+        throw;
+    }
+    sl::tinydir::path(path).remove_quietly();
+}
+
+void test_wakeup_idle_poll() {
+    raw_http_server server(RAW_TCP_PORT, [](const raw_http_request&) {
+        return raw_http_server::response("200 OK", {}, GET_RESPONSE);
+    });
+    auto session = sl::http::polling_session();
+    auto producer = std::thread([&session] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        auto opts = sl::http::request_options();
+        opts.method = "GET";
+        opts.record_timeline = true;
+        session.submit_url(RAW_URL + "wakeup", opts);
+    });
+    auto vec = std::vector<sl::http::resource>();
+    auto start = std::chrono::steady_clock::now();
+    // idle wait is interrupted by the submission
+    auto count = session.poll(5000, 1, vec);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    producer.join();
+    slassert(1 == count);
+    slassert(1 == vec.size());
+    slassert(200 == vec.front().get_status_code());
+    slassert(elapsed < std::chrono::milliseconds(2500));
+    // submitted on producer thread, dequeued by poll
+    auto tl = vec.front().get_timeline();
+    slassert(tl.submitted > 0);
+    slassert(tl.dequeued >= tl.submitted);
+    slassert(tl.multi_added >= tl.dequeued);
+}
+
+void test_timed_poll() {
+    raw_http_server server(RAW_TCP_PORT, [](const raw_http_request& req) {
+        if ("/slow" == req.path) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+        }
+        return raw_http_server::response("200 OK", {}, GET_RESPONSE);
+    });
+    auto session = sl::http::polling_session();
+    auto opts = sl::http::request_options();
+    opts.method = "GET";
+    // "out" is appended to
+    auto out = std::vector<sl::http::resource>();
+    auto first_id = session.open_url(RAW_URL + "fast", opts).get_id();
+    slassert(1 == session.poll(5000, 1, out));
+    slassert(1 == out.size());
+    slassert(first_id == out.front().get_id());
+    // min completions
+    for (size_t i = 0; i < 3; i++) {
+        session.open_url(RAW_URL + "fast", opts);
+    }
+    auto count = session.poll(5000, 2, out);
+    slassert(count >= 2);
+    slassert(1 + count == out.size());
+    slassert(first_id == out.front().get_id());
+    while (session.enqueued_requests_count() > 0) {
+        count += session.poll(5000, 1, out);
+    }
+    slassert(3 == count);
+    slassert(4 == out.size());
+    // timeout
+    session.open_url(RAW_URL + "slow", opts);
+    auto start = std::chrono::steady_clock::now();
+    slassert(0 == session.poll(300, 1, out));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    slassert(elapsed >= std::chrono::milliseconds(300));
+    slassert(elapsed < std::chrono::milliseconds(1200));
+    slassert(4 == out.size());
+    slassert(1 == session.enqueued_requests_count());
+    slassert(1 == session.poll(5000, 1, out));
+    slassert(5 == out.size());
+    slassert(200 == out.back().get_status_code());
+}
 
 int main() {
     try {
         test_simple();
+        test_parallel_upload();
+        test_parallel_upload_retry();
+        test_parallel_download_fallback();
+        test_parallel_download_ranges();
+        test_parallel_download_range_ignored();
+        test_file_writer_backpressure();
+        test_response_body_spill();
+        test_unsized_and_head();
+        test_streaming();
+        test_submit_from_thread();
+        test_wakeup_idle_poll();
+        test_timed_poll();
         // too slow under valgrind
         //test_parallel();
     } catch (const std::exception& e) {
@@ -0,0 +1,223 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * File:   raw_http_server.hpp
+ * Author: alex
+ *
+ * Created on October 19, 2026, 2:10 PM
+ */
+
+#ifndef STATICLIB_HTTP_TEST_RAW_HTTP_SERVER_HPP
+#define STATICLIB_HTTP_TEST_RAW_HTTP_SERVER_HPP
+
+#include <cstdint>
+#include <atomic>
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <istream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "asio.hpp"
+
+// Minimal blocking plain HTTP server for the tests that need the full control
+// over the response bytes (partial bodies, chunked encoding, LF-only lines),
+// connections are served one by one on a single thread, each connection
+// is closed after the response is written.
+
+struct raw_http_request {
+    std::string method;
+    std::string path;
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::string body;
+
+    // header names are case-insensitive
+    std::string header(const std::string& name) const {
+        for (auto& en : headers) {
+            if (lower(en.first) == lower(name)) {
+                return en.second;
+            }
+        }
+        return std::string();
+    }
+
+    bool has_header(const std::string& name) const {
+        for (auto& en : headers) {
+            if (lower(en.first) == lower(name)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static std::string lower(const std::string& str) {
+        auto res = str;
+        std::transform(res.begin(), res.end(), res.begin(), [](char ch) {
+            return static_cast<char> (std::tolower(static_cast<unsigned char> (ch)));
+        });
+        return res;
+    }
+};
+
+class raw_http_server {
+public:
+    // returns raw response bytes
+    using handler_type = std::function<std::string(const raw_http_request&)>;
+
+private:
+    uint16_t port;
+    handler_type handler;
+    asio::io_service service;
+    asio::ip::tcp::acceptor acceptor;
+    std::atomic<bool> running;
+    std::mutex mutex;
+    std::vector<raw_http_request> requests;
+    std::thread worker;
+
+public:
+    raw_http_server(uint16_t port, handler_type handler) :
+    port(port),
+    handler(std::move(handler)),
+    acceptor(service, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), port)),
+    running(true) {
+        this->worker = std::thread([this] {
+            serve();
+        });
+    }
+
+    raw_http_server(const raw_http_server&) = delete;
+
+    raw_http_server& operator=(const raw_http_server&) = delete;
+
+    ~raw_http_server() {
+        stop();
+    }
+
+    void stop() {
+        if (!running.exchange(false)) return;
+        // wake up accept
+        asio::io_service wake_service;
+        asio::ip::tcp::socket sock(wake_service);
+        asio::error_code ec;
+        sock.connect(asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), port), ec);
+        worker.join();
+    }
+
+    // all requests received so far
+    std::vector<raw_http_request> received() {
+        std::lock_guard<std::mutex> guard{mutex};
+        return requests;
+    }
+
+    static std::string response(const std::string& status_line,
+            const std::vector<std::pair<std::string, std::string>>& headers,
+            const std::string& body, bool add_content_length = true) {
+        auto res = std::string("HTTP/1.1 ") + status_line + "\r\n";
+        for (auto& en : headers) {
+            res += en.first + ": " + en.second + "\r\n";
+        }
+        if (add_content_length) {
+            res += "Content-Length: " + std::to_string(body.length()) + "\r\n";
+        }
+        res += "Connection: close\r\n\r\n";
+        res += body;
+        return res;
+    }
+
+private:
+    void serve() {
+        while (running.load()) {
+            asio::ip::tcp::socket sock(service);
+            asio::error_code ec;
+            acceptor.accept(sock, ec);
+            if (ec || !running.load()) continue;
+            handle(sock);
+        }
+    }
+
+    void handle(asio::ip::tcp::socket& sock) {
+        asio::streambuf buf;
+        asio::error_code ec;
+        size_t head_len = asio::read_until(sock, buf, "\r\n\r\n", ec);
+        if (ec) return;
+        auto req = raw_http_request();
+        {
+            auto head = std::string(asio::buffers_begin(buf.data()),
+                    asio::buffers_begin(buf.data()) + static_cast<std::ptrdiff_t> (head_len));
+            buf.consume(head_len);
+            parse_head(head, req);
+        }
+        if ("100-continue" == raw_http_request::lower(req.header("Expect"))) {
+            asio::write(sock, asio::buffer(std::string("HTTP/1.1 100 Continue\r\n\r\n")), ec);
+        }
+        if ("chunked" == raw_http_request::lower(req.header("Transfer-Encoding"))) {
+            // chunk sizes are kept in body
+            size_t len = asio::read_until(sock, buf, "0\r\n\r\n", ec);
+            if (ec) return;
+            req.body = std::string(asio::buffers_begin(buf.data()),
+                    asio::buffers_begin(buf.data()) + static_cast<std::ptrdiff_t> (len));
+        } else if (req.has_header("Content-Length")) {
+            size_t cl = static_cast<size_t> (std::stoull(req.header("Content-Length")));
+            if (buf.size() < cl) {
+                asio::read(sock, buf, asio::transfer_exactly(cl - buf.size()), ec);
+                if (ec) return;
+            }
+            req.body = std::string(asio::buffers_begin(buf.data()),
+                    asio::buffers_begin(buf.data()) + static_cast<std::ptrdiff_t> (cl));
+        }
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            requests.push_back(req);
+        }
+        auto resp = handler(req);
+        asio::write(sock, asio::buffer(resp), ec);
+        sock.shutdown(asio::ip::tcp::socket::shutdown_both, ec);
+        sock.close(ec);
+    }
+
+    static void parse_head(const std::string& head, raw_http_request& req) {
+        size_t pos = 0;
+        bool first = true;
+        while (pos < head.length()) {
+            auto end = head.find("\r\n", pos);
+            if (std::string::npos == end || end == pos) break;
+            auto line = head.substr(pos, end - pos);
+            pos = end + 2;
+            if (first) {
+                auto sp1 = line.find(' ');
+                auto sp2 = line.find(' ', sp1 + 1);
+                req.method = line.substr(0, sp1);
+                req.path = line.substr(sp1 + 1, sp2 - sp1 - 1);
+                first = false;
+            } else {
+                auto colon = line.find(':');
+                if (std::string::npos == colon) continue;
+                auto value = line.substr(colon + 1);
+                value.erase(0, value.find_first_not_of(' '));
+                req.headers.emplace_back(line.substr(0, colon), value);
+            }
+        }
+    }
+};
+
+#endif /* STATICLIB_HTTP_TEST_RAW_HTTP_SERVER_HPP */
+
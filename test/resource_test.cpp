@@ -26,9 +26,13 @@
 #include <cstdint>
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <iostream>
+#include <memory>
+#include <sstream>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "asio.hpp"
 
@@ -39,9 +43,12 @@
 #include "staticlib/io.hpp"
 #include "staticlib/tinydir.hpp"
 
+#include "staticlib/http/file_body.hpp"
 #include "staticlib/http/multi_threaded_session.hpp"
 #include "staticlib/http/single_threaded_session.hpp"
 
+#include "raw_http_server.hpp"
+
 const uint16_t TCP_PORT = 8443;
 const std::string URL = std::string() + "https://127.0.0.1:" + sl::support::to_string(TCP_PORT) + "/";
 const std::string GET_RESPONSE = "Hello from GET\n";
@@ -52,6 +59,8 @@ const std::string DELETE_RESPONSE = "Hello from DELETE\n";
 const std::string SERVER_CERT_PATH = "../test/certificates/server/localhost.pem";
 const std::string CLIENT_CERT_PATH = "../test/certificates/client/testclient.pem";
 const std::string CA_PATH = "../test/certificates/server/staticlibs_test_ca.cer";
+const uint16_t RAW_TCP_PORT = 8081;
+const std::string RAW_URL = std::string() + "http://127.0.0.1:" + sl::support::to_string(RAW_TCP_PORT) + "/";
 
 bool throws_exc(std::function<void()> fun) {
     try {
@@ -79,6 +88,30 @@ void enrich_opts_ssl(sl::http::request_options& opts) {
     opts.ssl_keypasswd = "test";
 }
 
+std::string pattern_data(size_t len) {
+    auto res = std::string();
+    res.resize(len);
+    for (size_t i = 0; i < len; i++) {
+        res[i] = static_cast<char> ('a' + (i * 31) % 26);
+    }
+    return res;
+}
+
+// first response is cut in the middle, "range_response" answers the resumed request
+raw_http_server::handler_type resumable_handler(const std::string& body,
+        std::function<std::string(const raw_http_request&)> range_response) {
+    return [body, range_response](const raw_http_request& req) {
+        if (req.has_header("Range")) {
+            return range_response(req);
+        }
+        auto resp = raw_http_server::response("200 OK", {
+            {"ETag", "\"v1\""},
+            {"Content-Length", sl::support::to_string(body.length())}
+        }, body.substr(0, body.length() / 2), false);
+        return resp;
+    };
+}
+
 void get_handler(sl::pion::http_request_ptr req, sl::pion::response_writer_ptr resp) {
     slassert("test" == req->get_header("User-Agent"));
     slassert("GET" == req->get_header("X-Method"));
@@ -163,6 +196,39 @@ void request_get(sl::http::session& session) {
     std::streamsize res = sl::io::read_all(src, out);
     slassert(out.size() == static_cast<size_t>(res));
     slassert(GET_RESPONSE == out);
+    // headers
+    auto& headers = src.get_headers();
+    slassert(headers.size() > 0);
+    slassert(std::addressof(headers) == std::addressof(src.get_headers()));
+    slassert(sl::support::to_string(GET_RESPONSE.length()) == src.get_header("Content-Length"));
+    // info, available after EOF
+    std::array<char, 1> tail;
+    slassert(std::char_traits<char>::eof() == src.read(tail));
+    auto info = src.get_info();
+    slassert(static_cast<int64_t>(GET_RESPONSE.size()) == info.size_download_bytes);
+    slassert(info.total_time_micros >= 0);
+    slassert(info.total_time_micros == src.get_info().total_time_micros);
+}
+
+void request_get_file(sl::http::multi_threaded_session& session) {
+    auto path = std::string("request_get_file.txt");
+    sl::http::request_options opts{};
+    opts.headers = {{"User-Agent", "test"}, {"X-Method", "GET"}};
+    enrich_opts_ssl(opts);
+    opts.method = "GET";
+    opts.multi_threaded_response_body_file_path = path;
+    opts.multi_threaded_response_body_file_batch_size_bytes = 4;
+    {
+        sl::http::resource src = session.open_url(URL + "get", opts);
+        slassert(200 == src.get_status_code());
+        std::array<char, 1> tail;
+        slassert(std::char_traits<char>::eof() == src.read(tail));
+    }
+    auto fsrc = sl::tinydir::file_source(path);
+    auto sink = sl::io::string_sink();
+    sl::io::copy_all(fsrc, sink);
+    slassert(GET_RESPONSE == sink.get_string());
+    sl::tinydir::path(path).remove_quietly();
 }
 
 void request_post(sl::http::session& session) {
@@ -180,6 +246,66 @@ void request_post(sl::http::session& session) {
     slassert(POST_RESPONSE == out);
 }
 
+void request_post_body(sl::http::session& session) {
+    sl::http::request_options opts{};
+    opts.headers = {{"User-Agent", "test"}, {"X-Method", "POST"}};
+    enrich_opts_ssl(opts);
+    // shared contiguous body
+    auto shared = std::make_shared<const std::string>(POSTPUT_DATA);
+    for (size_t i = 0; i < 2; i++) {
+        sl::http::resource src = session.open_url(URL + "post", sl::http::request_body(shared), opts);
+        std::string out{};
+        out.resize(POST_RESPONSE.size());
+        sl::io::read_all(src, out);
+        slassert(POST_RESPONSE == out);
+    }
+    // segments
+    auto half = POSTPUT_DATA.size() / 2;
+    auto segments = std::vector<sl::io::span<const char>>();
+    segments.emplace_back(POSTPUT_DATA.data(), half);
+    segments.emplace_back(POSTPUT_DATA.data() + half, POSTPUT_DATA.size() - half);
+    sl::http::resource src = session.open_url(URL + "post", sl::http::request_body(segments), opts);
+    std::string out{};
+    out.resize(POST_RESPONSE.size());
+    sl::io::read_all(src, out);
+    slassert(POST_RESPONSE == out);
+    // mapped file
+    auto path = std::string("request_post_body.txt");
+    {
+        auto sink = sl::tinydir::file_sink(path);
+        sink.write({POSTPUT_DATA.data(), POSTPUT_DATA.size()});
+    }
+    {
+        sl::http::resource fsrc = session.open_url(URL + "post", sl::http::map_file_body(path), opts);
+        std::string fout{};
+        fout.resize(POST_RESPONSE.size());
+        sl::io::read_all(fsrc, fout);
+        slassert(POST_RESPONSE == fout);
+    }
+    sl::tinydir::path(path).remove_quietly();
+}
+
+void request_post_stream(sl::http::multi_threaded_session& session) {
+    sl::http::request_options opts{};
+    opts.headers = {{"User-Agent", "test"}, {"X-Method", "POST"}};
+    enrich_opts_ssl(opts);
+    sl::http::upload_stream post_data{2};
+    sl::http::resource src = session.open_url(URL + "post", post_data, opts);
+    auto producer = std::thread([&post_data] {
+        // transfer is paused until the data arrives
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        post_data.write({POSTPUT_DATA.data(), POSTPUT_DATA.size()});
+        post_data.close();
+    });
+    // check
+    std::string out{};
+    out.resize(POST_RESPONSE.size());
+    std::streamsize res = sl::io::read_all(src, out);
+    producer.join();
+    slassert(out.size() == static_cast<size_t> (res));
+    slassert(POST_RESPONSE == out);
+}
+
 void request_put(sl::http::session& session) {
     sl::http::request_options opts{};
     opts.headers = {{"User-Agent", "test"}, {"X-Method", "PUT"}};
@@ -307,8 +433,12 @@ void test_methods() {
         auto mt = sl::http::multi_threaded_session();
         request_get(st);
         request_get(mt);
+        request_get_file(mt);
         request_post(st);
         request_post(mt);
+        request_post_body(st);
+        request_post_body(mt);
+        request_post_stream(mt);
         request_put(st);
         request_put(mt);
         request_delete(st);
@@ -416,6 +546,231 @@ void test_queue() {
     server.stop(true);
 }
 
+void test_resume() {
+    auto body = pattern_data(64 << 10);
+    auto half = body.length() / 2;
+    auto opts = sl::http::request_options();
+    opts.method = "GET";
+    opts.resume_max_attempts = 1;
+    auto mt = sl::http::multi_threaded_session();
+    // successful resume
+    {
+        raw_http_server server(RAW_TCP_PORT, resumable_handler(body, [&body, half](const raw_http_request&) {
+            return raw_http_server::response("206 Partial Content", {
+                {"Content-Range", "bytes " + sl::support::to_string(half) + "-" +
+                        sl::support::to_string(body.length() - 1) + "/" + sl::support::to_string(body.length())}
+            }, body.substr(half));
+        }));
+        auto src = mt.open_url(RAW_URL + "resume", opts);
+        auto sink = sl::io::string_sink();
+        sl::io::copy_all(src, sink);
+        slassert(body == sink.get_string());
+        slassert(200 == src.get_status_code());
+        auto reqs = server.received();
+        slassert(2 == reqs.size());
+        for (auto& req : reqs) {
+            // offsets must not be affected by content decoding
+            slassert(!req.has_header("Accept-Encoding"));
+        }
+        slassert(!reqs[0].has_header("Range"));
+        slassert("bytes=" + sl::support::to_string(half) + "-" == reqs[1].header("Range"));
+        slassert("\"v1\"" == reqs[1].header("If-Range"));
+    }
+    // validator changed
+    {
+        raw_http_server server(RAW_TCP_PORT, resumable_handler(body, [&body](const raw_http_request&) {
+            return raw_http_server::response("200 OK", {{"ETag", "\"v2\""}}, body);
+        }));
+        slassert(throws_exc([&] {
+            auto src = mt.open_url(RAW_URL + "resume", opts);
+            auto sink = sl::io::string_sink();
+            sl::io::copy_all(src, sink);
+        }));
+        slassert(2 == server.received().size());
+    }
+    // wrong "Content-Range"
+    {
+        raw_http_server server(RAW_TCP_PORT, resumable_handler(body, [&body](const raw_http_request&) {
+            return raw_http_server::response("206 Partial Content", {
+                {"Content-Range", "bytes 0-" + sl::support::to_string(body.length() - 1) +
+                        "/" + sl::support::to_string(body.length())}
+            }, body);
+        }));
+        slassert(throws_exc([&] {
+            auto src = mt.open_url(RAW_URL + "resume", opts);
+            auto sink = sl::io::string_sink();
+            sl::io::copy_all(src, sink);
+        }));
+        slassert(2 == server.received().size());
+    }
+}
+
+void test_metrics_curl_code() {
+    auto body = pattern_data(16 << 10);
+    raw_http_server server(RAW_TCP_PORT, resumable_handler(body, [](const raw_http_request&) {
+        return std::string();
+    }));
+    auto st = sl::http::single_threaded_session();
+    auto opts = sl::http::request_options();
+    opts.method = "GET";
+    {
+        auto src = st.open_url(RAW_URL + "partial", opts);
+        auto sink = sl::io::string_sink();
+        sl::io::copy_all(src, sink);
+        slassert(body.length() / 2 == sink.get_string().length());
+    }
+    auto mx = st.get_metrics();
+    slassert(1 == mx.requests_submitted);
+    slassert(0 == mx.requests_completed);
+    slassert(1 == mx.requests_failed);
+    slassert(1 == mx.errors_by_curl_code.size());
+    // CURLE_PARTIAL_FILE
+    slassert(18 == mx.errors_by_curl_code.front().first);
+}
+
+void request_dynamic_headers(sl::http::session& session, raw_http_server& server) {
+    auto opts = sl::http::request_options();
+    opts.method = "GET";
+    opts.headers = {{"X-Static", "static"}};
+    for (size_t i = 0; i < 3; i++) {
+        opts.dynamic_headers = {{"X-Dynamic", sl::support::to_string(i)}};
+        auto src = session.open_url(RAW_URL + "dynamic", opts);
+        auto sink = sl::io::string_sink();
+        sl::io::copy_all(src, sink);
+        slassert(GET_RESPONSE == sink.get_string());
+        auto req = server.received().back();
+        slassert("static" == req.header("X-Static"));
+        slassert(sl::support::to_string(i) == req.header("X-Dynamic"));
+    }
+    // dynamic headers are not kept in the cached list
+    opts.dynamic_headers.clear();
+    auto src = session.open_url(RAW_URL + "dynamic", opts);
+    auto sink = sl::io::string_sink();
+    sl::io::copy_all(src, sink);
+    auto req = server.received().back();
+    slassert("static" == req.header("X-Static"));
+    slassert(!req.has_header("X-Dynamic"));
+}
+
+void test_dynamic_headers() {
+    raw_http_server server(RAW_TCP_PORT, [](const raw_http_request&) {
+        return raw_http_server::response("200 OK", {}, GET_RESPONSE);
+    });
+    auto st = sl::http::single_threaded_session();
+    auto mt = sl::http::multi_threaded_session();
+    request_dynamic_headers(st, server);
+    request_dynamic_headers(mt, server);
+}
+
+void request_upload_headers(sl::http::session& session, raw_http_server& server) {
+    auto data = pattern_data(16 << 10);
+    auto opts = sl::http::request_options();
+    opts.method = "POST";
+    // seekable stream, size is detected
+    {
+        auto stream = std::unique_ptr<std::istream>(new std::istringstream(data));
+        auto src = session.open_url(RAW_URL + "upload", std::move(stream), opts);
+        auto sink = sl::io::string_sink();
+        sl::io::copy_all(src, sink);
+        auto req = server.received().back();
+        slassert(sl::support::to_string(data.length()) == req.header("Content-Length"));
+        slassert(!req.has_header("Transfer-Encoding"));
+        slassert(!req.has_header("Expect"));
+        slassert(data == req.body);
+    }
+    // unsized stream
+    {
+        auto src = session.open_url(RAW_URL + "upload", sl::io::string_source(data), opts);
+        auto sink = sl::io::string_sink();
+        sl::io::copy_all(src, sink);
+        auto req = server.received().back();
+        slassert(!req.has_header("Content-Length"));
+        slassert("chunked" == req.header("Transfer-Encoding"));
+        slassert(!req.has_header("Expect"));
+    }
+    // "Expect" is allowed explicitly, cURL sends it for large bodies
+    {
+        auto large = pattern_data(2 << 20);
+        auto expect_opts = opts;
+        expect_opts.send_expect_100_continue = true;
+        auto stream = std::unique_ptr<std::istream>(new std::istringstream(large));
+        auto src = session.open_url(RAW_URL + "upload", std::move(stream), expect_opts);
+        auto sink = sl::io::string_sink();
+        sl::io::copy_all(src, sink);
+        auto req = server.received().back();
+        slassert("100-continue" == req.header("Expect"));
+        slassert(large == req.body);
+    }
+}
+
+void request_put_body_headers(sl::http::session& session, raw_http_server& server) {
+    auto data = pattern_data(16 << 10);
+    auto opts = sl::http::request_options();
+    opts.method = "PUT";
+    // contiguous body, no form content type is added
+    {
+        auto src = session.open_url(RAW_URL + "put", sl::http::request_body({data.data(), data.length()}), opts);
+        auto sink = sl::io::string_sink();
+        sl::io::copy_all(src, sink);
+        auto req = server.received().back();
+        slassert("PUT" == req.method);
+        slassert(sl::support::to_string(data.length()) == req.header("Content-Length"));
+        slassert(!req.has_header("Content-Type"));
+        slassert(!req.has_header("Transfer-Encoding"));
+        slassert(!req.has_header("Expect"));
+        slassert(data == req.body);
+    }
+    // content type specified by caller
+    {
+        auto typed_opts = opts;
+        typed_opts.headers.emplace_back("Content-Type", "application/octet-stream");
+        auto src = session.open_url(RAW_URL + "put", sl::http::request_body({data.data(), data.length()}), typed_opts);
+        auto sink = sl::io::string_sink();
+        sl::io::copy_all(src, sink);
+        auto req = server.received().back();
+        slassert("application/octet-stream" == req.header("Content-Type"));
+        slassert(data == req.body);
+    }
+}
+
+void test_upload_headers() {
+    raw_http_server server(RAW_TCP_PORT, [](const raw_http_request&) {
+        return raw_http_server::response("200 OK", {}, POST_RESPONSE);
+    });
+    auto st = sl::http::single_threaded_session();
+    auto mt = sl::http::multi_threaded_session();
+    request_upload_headers(st, server);
+    request_upload_headers(mt, server);
+    request_put_body_headers(st, server);
+    request_put_body_headers(mt, server);
+}
+
+void request_lf_headers(sl::http::session& session) {
+    auto opts = sl::http::request_options();
+    opts.method = "GET";
+    auto src = session.open_url(RAW_URL + "lf", opts);
+    slassert(200 == src.get_status_code());
+    slassert("lf" == src.get_header("X-Test"));
+    auto sink = sl::io::string_sink();
+    sl::io::copy_all(src, sink);
+    slassert(GET_RESPONSE == sink.get_string());
+}
+
+void test_lf_headers() {
+    // some servers terminate header lines with "\n" only
+    raw_http_server server(RAW_TCP_PORT, [](const raw_http_request&) {
+        return std::string() + "HTTP/1.1 200 OK\n" +
+                "Content-Length: " + sl::support::to_string(GET_RESPONSE.length()) + "\n" +
+                "X-Test: lf\n" +
+                "Connection: close\n" +
+                "\n" + GET_RESPONSE;
+    });
+    auto st = sl::http::single_threaded_session();
+    auto mt = sl::http::multi_threaded_session();
+    request_lf_headers(st);
+    request_lf_headers(mt);
+}
+
 int main() {
     try {
 //        auto start = std::chrono::system_clock::now();
@@ -423,6 +778,11 @@ int main() {
         test_connectfail();
         test_single();
         test_status_fail();
+        test_resume();
+        test_metrics_curl_code();
+        test_dynamic_headers();
+        test_upload_headers();
+        test_lf_headers();
 //        test_stress();
 //        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start);
 //        std::cout << "millis elapsed: " << elapsed.count() << std::endl;
@@ -0,0 +1,366 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   soak_bench.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 7:40 PM
+ */
+
+// Long-running soak run against a local server, mixes GET, POST and
+// streaming requests with server-side stalls (aborted by client timeouts),
+// connections reset by the server in the middle of the response body
+// and refused connections. Every interval latency percentiles, open fd count
+// and RSS are written to stdout as CSV.
+// Exits with non-zero code if fd count or RSS grow over the specified limits.
+//
+// Usage (from the build directory, Linux only):
+//
+//     ./staticlib_http_soak_bench [duration_secs=600] [interval_secs=60] [threads=8]
+//             [max_fd_growth=64] [max_rss_growth_kb=0]
+
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include "asio.hpp"
+
+#include "staticlib/pion.hpp"
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/http.hpp"
+
+namespace { // anonymous
+
+const uint16_t TCP_PORT = 8080;
+// nothing listens here, connections are refused
+const uint16_t CLOSED_PORT = 8081;
+const uint16_t RESET_PORT = 8082;
+const std::string URL = "http://127.0.0.1:" + sl::support::to_string(TCP_PORT) + "/";
+const size_t STREAM_SIZE = 4 << 20;
+
+struct soak_config {
+    uint32_t duration_secs = 600;
+    uint32_t interval_secs = 60;
+    uint32_t threads = 8;
+    uint64_t max_fd_growth = 64;
+    uint64_t max_rss_growth_kb = 0;
+};
+
+class interval_stats {
+    std::mutex mutex;
+    std::vector<uint64_t> latencies;
+    uint64_t errors = 0;
+
+public:
+    void record(uint64_t latency_micros, bool success) {
+        std::lock_guard<std::mutex> guard{mutex};
+        latencies.push_back(latency_micros);
+        if (!success) {
+            errors += 1;
+        }
+    }
+
+    std::pair<std::vector<uint64_t>, uint64_t> take() {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto res = std::make_pair(std::move(latencies), errors);
+        latencies = std::vector<uint64_t>();
+        errors = 0;
+        return res;
+    }
+};
+
+uint64_t now_micros() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t> (std::chrono::duration_cast<std::chrono::microseconds>(now).count());
+}
+
+uint64_t rss_kb() {
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size = 0;
+    uint64_t resident = 0;
+    statm >> size >> resident;
+    return resident * static_cast<uint64_t> (sysconf(_SC_PAGESIZE)) / 1024;
+}
+
+uint64_t fd_count() {
+    uint64_t res = 0;
+    auto dir = opendir("/proc/self/fd");
+    if (nullptr == dir) {
+        return 0;
+    }
+    while (nullptr != readdir(dir)) {
+        res += 1;
+    }
+    closedir(dir);
+    // '.', '..' and the dir itself
+    return res > 3 ? res - 3 : 0;
+}
+
+uint64_t percentile(const std::vector<uint64_t>& sorted, double pct) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    auto idx = static_cast<size_t> (static_cast<double> (sorted.size() - 1) * pct / 100);
+    return sorted[idx];
+}
+
+// sends headers and a part of the body, then resets the connection,
+// requests are not recorded to not affect RSS readings
+class reset_server {
+    asio::io_service service;
+    asio::ip::tcp::acceptor acceptor;
+    std::atomic<bool> running;
+    std::thread worker;
+
+public:
+    reset_server() :
+    acceptor(service, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), RESET_PORT)),
+    running(true) {
+        this->worker = std::thread([this] {
+            serve();
+        });
+    }
+
+    reset_server(const reset_server&) = delete;
+
+    reset_server& operator=(const reset_server&) = delete;
+
+    ~reset_server() {
+        stop();
+    }
+
+    void stop() {
+        if (!running.exchange(false)) return;
+        // wake up accept
+        asio::io_service wake_service;
+        asio::ip::tcp::socket sock(wake_service);
+        asio::error_code ec;
+        sock.connect(asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), RESET_PORT), ec);
+        worker.join();
+    }
+
+private:
+    void serve() {
+        static std::string head = "HTTP/1.1 200 OK\r\n"
+                "Content-Length: " + sl::support::to_string(STREAM_SIZE) + "\r\n\r\n";
+        static std::string partial = std::string(65536, 'r');
+        while (running.load()) {
+            asio::ip::tcp::socket sock(service);
+            asio::error_code ec;
+            acceptor.accept(sock, ec);
+            if (ec || !running.load()) continue;
+            asio::streambuf buf;
+            asio::read_until(sock, buf, "\r\n\r\n", ec);
+            if (ec) continue;
+            asio::write(sock, asio::buffer(head), ec);
+            asio::write(sock, asio::buffer(partial), ec);
+            // zero linger makes close send RST instead of FIN
+            sock.set_option(asio::socket_base::linger(true, 0), ec);
+            sock.close(ec);
+        }
+    }
+};
+
+void start_server(sl::pion::http_server& server) {
+    static std::string small = "{\"soak\": true}";
+    static std::string stream = std::string(STREAM_SIZE, 's');
+    server.add_handler("GET", "/get", [](sl::pion::http_request_ptr, sl::pion::response_writer_ptr resp) {
+        resp->write(small);
+        resp->send(std::move(resp));
+    });
+    server.add_handler("POST", "/post", [](sl::pion::http_request_ptr, sl::pion::response_writer_ptr resp) {
+        resp->write(small);
+        resp->send(std::move(resp));
+    });
+    server.add_handler("GET", "/stream", [](sl::pion::http_request_ptr, sl::pion::response_writer_ptr resp) {
+        resp->write(stream);
+        resp->send(std::move(resp));
+    });
+    server.add_handler("GET", "/stall", [](sl::pion::http_request_ptr, sl::pion::response_writer_ptr resp) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        resp->write(small);
+        resp->send(std::move(resp));
+    });
+    server.start();
+}
+
+// returns false only on unexpected failure,
+// stalls, resets and refused connections are expected to fail
+bool run_one(sl::http::multi_threaded_session& session, std::mt19937& rng,
+        std::array<char, 16384>& buf) {
+    auto opts = sl::http::request_options();
+    opts.method = "GET";
+    auto dice = rng() % 100;
+    std::string url = URL + "get";
+    bool expect_failure = false;
+    bool slow_consumer = false;
+    std::string post_data;
+    if (dice < 40) {
+        // plain get
+    } else if (dice < 70) {
+        opts.method = "POST";
+        post_data = std::string(rng() % 65536, 'p');
+        url = URL + "post";
+    } else if (dice < 90) {
+        url = URL + "stream";
+        // lets the worker pause the transfer
+        slow_consumer = 0 == dice % 2;
+    } else if (dice < 93) {
+        url = URL + "stall";
+        opts.timeout_millis = 100;
+        expect_failure = true;
+    } else if (dice < 97) {
+        url = "http://127.0.0.1:" + sl::support::to_string(RESET_PORT) + "/";
+        expect_failure = true;
+    } else {
+        url = "http://127.0.0.1:" + sl::support::to_string(CLOSED_PORT) + "/";
+        opts.connecttimeout_millis = 1000;
+        expect_failure = true;
+    }
+    try {
+        auto src = sl::io::string_source(post_data);
+        auto res = "POST" == opts.method ? session.open_url(url, src, opts) : session.open_url(url, opts);
+        for (;;) {
+            auto read = res.read({buf.data(), buf.size()});
+            if (std::char_traits<char>::eof() == read) break;
+            if (slow_consumer) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+        bool success = res.connection_successful() && 200 == res.get_status_code();
+        return success || expect_failure;
+    } catch (const std::exception&) {
+        return expect_failure;
+    }
+}
+
+soak_config parse_args(int argc, char** argv) {
+    auto conf = soak_config();
+    for (int i = 1; i < argc; i++) {
+        auto arg = std::string(argv[i]);
+        auto eq = arg.find('=');
+        if (std::string::npos == eq) throw sl::support::exception(TRACEMSG(
+                "Invalid argument: [" + arg + "], expected 'name=value'"));
+        auto name = arg.substr(0, eq);
+        auto value = static_cast<uint64_t> (std::stoull(arg.substr(eq + 1)));
+        if ("duration_secs" == name) {
+            conf.duration_secs = static_cast<uint32_t> (value);
+        } else if ("interval_secs" == name) {
+            conf.interval_secs = static_cast<uint32_t> (value);
+        } else if ("threads" == name) {
+            conf.threads = static_cast<uint32_t> (value);
+        } else if ("max_fd_growth" == name) {
+            conf.max_fd_growth = value;
+        } else if ("max_rss_growth_kb" == name) {
+            conf.max_rss_growth_kb = value;
+        } else {
+            throw sl::support::exception(TRACEMSG("Invalid argument name: [" + name + "]"));
+        }
+    }
+    if (0 == conf.interval_secs) throw sl::support::exception(TRACEMSG("Invalid zero 'interval_secs' argument"));
+    return conf;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        auto conf = parse_args(argc, argv);
+        sl::pion::http_server server(8, TCP_PORT);
+        start_server(server);
+        reset_server resetter;
+        auto session = sl::http::multi_threaded_session();
+        interval_stats stats;
+        std::atomic<bool> running{true};
+        std::atomic<uint64_t> total{0};
+        auto threads = std::vector<std::thread>();
+        for (uint32_t t = 0; t < conf.threads; t++) {
+            threads.emplace_back([&, t] {
+                auto rng = std::mt19937(t);
+                auto buf = std::array<char, 16384>();
+                while (running.load(std::memory_order_acquire)) {
+                    auto start = now_micros();
+                    bool success = run_one(session, rng, buf);
+                    stats.record(now_micros() - start, success);
+                    total.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+
+        // reporter
+        std::cout << "elapsed_secs,requests,errors,p50_us,p99_us,p999_us,fd_count,rss_kb" << std::endl;
+        auto fd_start = fd_count();
+        auto rss_start = rss_kb();
+        auto fd_last = fd_start;
+        auto rss_last = rss_start;
+        uint64_t errors_total = 0;
+        for (uint32_t elapsed = 0; elapsed < conf.duration_secs; ) {
+            auto step = std::min(conf.interval_secs, conf.duration_secs - elapsed);
+            std::this_thread::sleep_for(std::chrono::seconds(step));
+            elapsed += step;
+            auto pa = stats.take();
+            auto& lat = pa.first;
+            std::sort(lat.begin(), lat.end());
+            fd_last = fd_count();
+            rss_last = rss_kb();
+            errors_total += pa.second;
+            std::cout << elapsed << "," << lat.size() << "," << pa.second << ","
+                    << percentile(lat, 50) << "," << percentile(lat, 99) << ","
+                    << percentile(lat, 99.9) << "," << fd_last << "," << rss_last << std::endl;
+        }
+        running.store(false, std::memory_order_release);
+        for (auto& th : threads) {
+            th.join();
+        }
+        server.stop(true);
+        resetter.stop();
+
+        // drift check
+        auto fd_growth = fd_last > fd_start ? fd_last - fd_start : 0;
+        auto rss_growth = rss_last > rss_start ? rss_last - rss_start : 0;
+        std::cerr << "total requests: [" << total.load() << "], errors: [" << errors_total << "]," <<
+                " fd growth: [" << fd_growth << "], RSS growth KB: [" << rss_growth << "]" << std::endl;
+        if (fd_growth > conf.max_fd_growth) {
+            std::cerr << "FAIL: fd count growth exceeded limit: [" << conf.max_fd_growth << "]" << std::endl;
+            return 2;
+        }
+        if (conf.max_rss_growth_kb > 0 && rss_growth > conf.max_rss_growth_kb) {
+            std::cerr << "FAIL: RSS growth exceeded limit: [" << conf.max_rss_growth_kb << "]" << std::endl;
+            return 2;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   upload_bench.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 10:30 PM
+ */
+
+// File upload benchmark against a local server, compares streaming the file
+// through 'file_source' (chunked encoding, copied through the streambuf)
+// with the memory-mapped body ('map_file_body'), results are written
+// to stdout as CSV.
+//
+// Usage (from the build directory):
+//
+//     ./staticlib_http_upload_bench [modes=stream,mmap] [size_mb=1024] [runs=3]
+//
+// CPU time is a process time and includes the in-process server.
+
+#include <cstdint>
+#include <ctime>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "staticlib/pion.hpp"
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+#include "staticlib/tinydir.hpp"
+
+#include "staticlib/http.hpp"
+
+namespace { // anonymous
+
+const uint16_t TCP_PORT = 8080;
+const std::string URL = "http://127.0.0.1:" + sl::support::to_string(TCP_PORT) + "/upload";
+const std::string FILE_PATH = "staticlib_http_upload_bench.bin";
+
+struct bench_config {
+    std::vector<std::string> modes = {"stream", "mmap"};
+    uint32_t size_mb = 1024;
+    uint32_t runs = 3;
+};
+
+// counts received bytes only
+class counting_receiver {
+    std::shared_ptr<std::atomic<uint64_t>> received;
+
+public:
+    counting_receiver(std::shared_ptr<std::atomic<uint64_t>> received) :
+    received(std::move(received)) { }
+
+    void operator()(const char*, size_t n) {
+        received->fetch_add(n, std::memory_order_relaxed);
+    }
+};
+
+uint64_t now_micros() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t> (std::chrono::duration_cast<std::chrono::microseconds>(now).count());
+}
+
+std::string fixed2(double val) {
+    auto scaled = static_cast<uint64_t> (val * 100 + 0.5);
+    auto frac = sl::support::to_string(scaled % 100);
+    return sl::support::to_string(scaled / 100) + "." + (frac.length() < 2 ? "0" : "") + frac;
+}
+
+void write_file(uint32_t size_mb) {
+    auto chunk = std::string(1 << 20, 'u');
+    std::ofstream out(FILE_PATH, std::ios::binary | std::ios::trunc);
+    for (uint32_t i = 0; i < size_mb; i++) {
+        out.write(chunk.data(), static_cast<std::streamsize> (chunk.size()));
+    }
+    out.close();
+    if (!out) throw sl::support::exception(TRACEMSG("Error writing file: [" + FILE_PATH + "]"));
+}
+
+void upload_once(sl::http::multi_threaded_session& session, const std::string& mode) {
+    auto opts = sl::http::request_options();
+    opts.method = "POST";
+    opts.timeout_millis = 0;
+    auto res = [&]() -> sl::http::resource {
+        if ("stream" == mode) {
+            auto src = sl::tinydir::file_source(FILE_PATH);
+            return session.open_url(URL, std::move(src), opts);
+        } else if ("mmap" == mode) {
+            return session.open_url(URL, sl::http::map_file_body(FILE_PATH), opts);
+        }
+        throw sl::support::exception(TRACEMSG("Invalid mode: [" + mode + "]"));
+    }();
+    auto buf = std::array<char, 1024>();
+    while (std::char_traits<char>::eof() != res.read({buf.data(), buf.size()})) { }
+    if (!res.connection_successful() || 200 != res.get_status_code()) {
+        throw sl::support::exception(TRACEMSG("Upload failed, mode: [" + mode + "]," +
+                " error: [" + res.get_error() + "]"));
+    }
+}
+
+void run_mode(const bench_config& conf, const std::string& mode, std::atomic<uint64_t>& received) {
+    auto session = sl::http::multi_threaded_session();
+    received.store(0, std::memory_order_relaxed);
+    auto cpu_start = std::clock();
+    auto wall_start = now_micros();
+    for (uint32_t i = 0; i < conf.runs; i++) {
+        upload_once(session, mode);
+    }
+    auto wall_micros = now_micros() - wall_start;
+    auto cpu_ms = static_cast<double> (std::clock() - cpu_start) * 1000 / CLOCKS_PER_SEC;
+    uint64_t expected = static_cast<uint64_t> (conf.size_mb) * conf.runs << 20;
+    slassert(expected == received.load(std::memory_order_relaxed));
+    double secs = static_cast<double> (wall_micros > 0 ? wall_micros : 1) / 1000000;
+    double total_mb = static_cast<double> (conf.size_mb) * conf.runs;
+    std::cout << mode << "," << conf.size_mb << "," << conf.runs << ","
+            << fixed2(total_mb / secs) << ","
+            << fixed2(cpu_ms / (total_mb / 1024)) << std::endl;
+}
+
+std::vector<std::string> split_list(const std::string& str) {
+    auto res = std::vector<std::string>();
+    size_t start = 0;
+    for (;;) {
+        auto pos = str.find(',', start);
+        res.push_back(str.substr(start, std::string::npos == pos ? pos : pos - start));
+        if (std::string::npos == pos) break;
+        start = pos + 1;
+    }
+    return res;
+}
+
+bench_config parse_args(int argc, char** argv) {
+    auto conf = bench_config();
+    for (int i = 1; i < argc; i++) {
+        auto arg = std::string(argv[i]);
+        auto eq = arg.find('=');
+        if (std::string::npos == eq) throw sl::support::exception(TRACEMSG(
+                "Invalid argument: [" + arg + "], expected 'name=value'"));
+        auto name = arg.substr(0, eq);
+        auto value = arg.substr(eq + 1);
+        if ("modes" == name) {
+            conf.modes = split_list(value);
+        } else if ("size_mb" == name) {
+            conf.size_mb = static_cast<uint32_t> (std::stoul(value));
+        } else if ("runs" == name) {
+            conf.runs = static_cast<uint32_t> (std::stoul(value));
+        } else {
+            throw sl::support::exception(TRACEMSG("Invalid argument name: [" + name + "]"));
+        }
+    }
+    if (0 == conf.size_mb || 0 == conf.runs) throw sl::support::exception(TRACEMSG(
+            "Invalid zero 'size_mb' or 'runs' argument"));
+    return conf;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        auto conf = parse_args(argc, argv);
+        write_file(conf.size_mb);
+        auto received = std::make_shared<std::atomic<uint64_t>>(0);
+        sl::pion::http_server server(2, TCP_PORT);
+        server.add_handler("POST", "/upload", [](sl::pion::http_request_ptr, sl::pion::response_writer_ptr resp) {
+            resp->write("OK");
+            resp->send(std::move(resp));
+        });
+        server.add_payload_handler("POST", "/upload", [received](sl::pion::http_request_ptr&) {
+            return counting_receiver(received);
+        });
+        server.start();
+        std::cout << "mode,size_mb,runs,mb_per_sec,cpu_ms_per_gb" << std::endl;
+        try {
+            for (auto& mode : conf.modes) {
+                run_mode(conf, mode, *received);
+            }
+        } catch (const std::exception&) {
+            server.stop(true);
+            sl::tinydir::path(FILE_PATH).remove_quietly();
+            throw;
+        }
+        server.stop(true);
+        sl::tinydir::path(FILE_PATH).remove_quietly();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}